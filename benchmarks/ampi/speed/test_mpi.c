@@ -73,6 +73,32 @@ void mpi_finish_fn(msg_comm *comm)
   c->doneFlag=1;	
 }
 
+/* Time short allreduces and broadcasts, which are bound by latency */
+void mpi_coll_test(MPI_Comm comm,int myRank)
+{
+  const int nIter=1000;
+  double buf[8], res[8];
+  int len, i;
+  for (len=1;len<=8;len*=2) {
+    double start, allreduceTime, bcastTime;
+    for (i=0;i<len;i++) buf[i]=myRank;
+    MPI_Barrier(comm);
+    start=msg_timer();
+    for (i=0;i<nIter;i++)
+      MPI_Allreduce(buf,res,len,MPI_DOUBLE,MPI_SUM,comm);
+    allreduceTime=msg_timer()-start;
+    MPI_Barrier(comm);
+    start=msg_timer();
+    for (i=0;i<nIter;i++)
+      MPI_Bcast(buf,len,MPI_DOUBLE,0,comm);
+    bcastTime=msg_timer()-start;
+    if (myRank==0)
+      printf("MPI Allreduce %d bytes: %.2f us, Bcast %d bytes: %.2f us\n",
+        (int)(len*sizeof(double)),1.0e6*allreduceTime/nIter,
+        (int)(len*sizeof(double)),1.0e6*bcastTime/nIter);
+  }
+}
+
 void startMPItest(MPI_Comm comm,int verbose)
 {
   int bufSize=2*1024*1024;
@@ -101,5 +127,7 @@ void startMPItest(MPI_Comm comm,int verbose)
   
   MPI_Buffer_detach(buf,&bufSize);
   free(buf);
+
+  mpi_coll_test(c->comm,c->myRank);
 }
 
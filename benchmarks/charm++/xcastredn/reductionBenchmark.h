@@ -22,6 +22,8 @@ enum CommMechanism
     rednCkMulticast,
     rednCharm,
     setRednCharm,
+    maxRednCharm,
+    tupleRednCharm,
     rednConverse,
     EndOfTest
 };
@@ -20,6 +20,8 @@ class TestController: public CBase_TestController
         CProxySection_MyChareArray createSection(const bool isSectionContiguous);
         /// Sends out a multicast to the array section
         void sendMulticast(const CommMechanism commType, const int msgSize);
+        /// Times the reducer functions alone over the range of msg sizes
+        void timeReducerKernels();
 
         /// Chare array that is going to receive the multicasts
         CProxy_MyChareArray chareArray;
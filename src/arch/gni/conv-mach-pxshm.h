@@ -10,6 +10,4 @@
 #undef CMK_WHEN_PROCESSOR_IDLE_USLEEP
 #define CMK_WHEN_PROCESSOR_IDLE_USLEEP  0
 
-#define PXSHM_LOCK                      1
-
 #endif
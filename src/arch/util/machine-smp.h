@@ -66,6 +66,28 @@ typedef struct {
 #endif
 #endif
 
+/*
+ * With lockless queues, or CMK_LOCKLESS_PE_RECV_QUEUE alone, the per-PE
+ * receive queue on LRTS layers is the MPSCQueue from pcqueue.h: any rank of
+ * the node (or the comm thread) pushes without taking a lock, and only the
+ * owning rank pops.
+ */
+#if (CMK_LOCKLESS_QUEUE || CMK_LOCKLESS_PE_RECV_QUEUE) && CMK_SMP && CMK_USE_LRTS && !CMK_SMP_MULTIQ && !SPECIFIC_PCQUEUE && !CMK_MACH_SPECIALIZED_QUEUE
+#define CMK_LOCKLESS_RECV_QUEUE 1
+#define CmiRecvQueue       MPSCQueue
+#define CmiRecvQueueCreate MPSCQueueCreate
+#define CmiRecvQueuePush   MPSCQueuePush
+#define CmiRecvQueuePop    MPSCQueuePop
+#define CmiRecvQueueEmpty  MPSCQueueEmpty
+#else
+#define CMK_LOCKLESS_RECV_QUEUE 0
+#define CmiRecvQueue       CMIQueue
+#define CmiRecvQueueCreate CMIQueueCreate
+#define CmiRecvQueuePush   CMIQueuePush
+#define CmiRecvQueuePop    CMIQueuePop
+#define CmiRecvQueueEmpty  CMIQueueEmpty
+#endif
+
 /************************************************************
  *
  * Processor state structure
@@ -76,7 +98,7 @@ typedef struct CmiStateStruct
 {
   int pe, rank;
 #if !CMK_SMP_MULTIQ
-  CMIQueue recv; 
+  CmiRecvQueue recv;
 #else
   CMIQueue recv[MULTIQ_GRPSIZE];
   int myGrpIdx;
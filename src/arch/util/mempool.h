@@ -20,6 +20,16 @@ typedef void (*mempool_freeblock)(void* ptr, mem_handle_t mem_hndl);
 
 #define cutOffNum CMK_MEMPOOL_CUTOFFNUM
 
+// pools that can be used by several threads are protected by a lock
+#define CMK_MEMPOOL_LOCKED (CMK_USE_MEMPOOL_ISOMALLOC || CMK_SMP)
+
+// per-thread caches of free slots (mempool_cache_*)
+#define MEMPOOL_CACHE_CLASSES 12  // slots of up to 64 << 11 bytes are cached
+#define MEMPOOL_CACHE_DEPTH   32  // slots cached per size class
+#define MEMPOOL_CACHE_REFILL  8   // slots taken from the pool at once on a miss
+#define MEMPOOL_CACHE_BATCH   32  // frees of other pools' slots returned at once
+#define MEMPOOL_CACHE_REMOTES 4   // other pools with pending frees
+
 //given x as mptr get
 #define MEMPOOL_GetBlockHead(x) (&((x)->block_head))
 //given x as block header, get ...
@@ -113,14 +123,42 @@ typedef struct mempool_type
   size_t block_tail;
   size_t limit;
   size_t size;
-#if CMK_USE_MEMPOOL_ISOMALLOC || (CMK_SMP && CMK_CONVERSE_UGNI)
+  size_t block_allocs, block_frees;  // calls of newblockfn/freeblockfn
+#if CMK_MEMPOOL_LOCKED
   CmiNodeLock mempoolLock;
-  char padding[CMIPADDING((6 * sizeof(size_t) + sizeof(CmiNodeLock)), 16)];
-#elif !CMK_64BIT
-  size_t padding[2];
+  char padding[CMIPADDING((8 * sizeof(size_t) + sizeof(CmiNodeLock)), 16)];
 #endif
 } mempool_type;
 
+typedef struct mempool_cache_stats
+{
+  size_t mallocs, hits;        // allocations, and those served by the cache
+  size_t frees, remote_frees;  // frees, and those of slots of other pools
+  size_t pool_locks;           // times a pool had to be entered
+} mempool_cache_stats;
+
+// slots of another pool waiting to be freed
+typedef struct mempool_remote_batch
+{
+  mempool_type* mptr;
+  int count;
+  void* slots[MEMPOOL_CACHE_BATCH];
+} mempool_remote_batch;
+
+// A thread's cache on top of its pool: free slots of the common size
+// classes are kept here and reused without entering (and locking) the pool,
+// and freed slots of other threads' pools are returned to them in batches.
+// A cache must only be used by one thread at a time.
+typedef struct mempool_cache
+{
+  mempool_type* mptr;  // the pool the cache allocates from
+  int classes;
+  int count[MEMPOOL_CACHE_CLASSES];
+  void* slots[MEMPOOL_CACHE_CLASSES][MEMPOOL_CACHE_DEPTH];
+  mempool_remote_batch remote[MEMPOOL_CACHE_REMOTES];
+  mempool_cache_stats stats;
+} mempool_cache;
+
 #ifdef __cplusplus
 static_assert(sizeof(slot_header) % 16 == 0, "slot_header is not a multiple of 16 bytes");
 static_assert(sizeof(used_header) % 16 == 0, "used_header is not a multiple of 16 bytes");
@@ -136,10 +174,23 @@ void mempool_destroy(mempool_type* mptr);
 void* mempool_malloc(mempool_type* mptr, size_t size, int expand);
 void* mempool_large_malloc(mempool_type* mptr, size_t size, int expand);
 void mempool_free(mempool_type* mptr, void* ptr_free);
-#if CMK_USE_MEMPOOL_ISOMALLOC || (CMK_SMP && CMK_CONVERSE_UGNI)
+#if CMK_MEMPOOL_LOCKED
 void mempool_free_thread(void* ptr_free);
 #endif
 
+mempool_cache* mempool_cache_init(mempool_type* mptr);
+// frees the cache only: call mempool_cache_flush first unless the pools
+// are about to be destroyed as well
+void mempool_cache_destroy(mempool_cache* cache);
+void* mempool_cache_malloc(mempool_cache* cache, size_t size, int expand);
+// ptr_free may belong to any pool
+void mempool_cache_free(mempool_cache* cache, void* ptr_free);
+// return all cached slots to their pools
+void mempool_cache_flush(mempool_cache* cache);
+// return the pending frees of other pools' slots
+void mempool_cache_flush_remote(mempool_cache* cache);
+void mempool_cache_print_stats(mempool_cache* cache);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -415,8 +415,10 @@ static void PCQueuePush(PCQueue Q, char *data)
 }
 #endif
 
-// CMK_LOCKLESS_QUEUE (disabled by default)
-#if CMK_LOCKLESS_QUEUE
+// Used for the PE and node queues with CMK_LOCKLESS_QUEUE, and for the
+// per-PE receive queue alone with CMK_LOCKLESS_PE_RECV_QUEUE (the default on
+// SMP builds, see configure.ac and machine-smp.h)
+#if CMK_LOCKLESS_QUEUE || CMK_LOCKLESS_PE_RECV_QUEUE
 
 /*
  * MPSC Queue Design - Justin Miron
@@ -440,6 +442,11 @@ static void PCQueuePush(PCQueue Q, char *data)
  * Memory Allocation: The first push in the first DataNode index of a data node allocates the node.
  * Memory Reclamation: The last push in the last DataNode frees the memory of the DataNode.
  *
+ * Memory Bound: at most QueueUpperBound (MaxDataNodes * DataNodeSize) entries are in flight; producers
+ * that would exceed it spin with sched_yield() and are counted in messageQueueOverflow.
+ *
+ * Slots are atomic so that a consumer never observes a message pointer before the stores that built
+ * the message: producers publish with release, the consumer reads with acquire.
  *
  */
 
@@ -448,7 +455,7 @@ static void PCQueuePush(PCQueue Q, char *data)
 #include <limits.h>
 #include <sched.h>
 
-typedef char** DataNode; //Data nodes are an array of char *
+typedef std::atomic<uintptr_t>* DataNode; //Data nodes are an array of char *
 
 // Queue parameters initialized in init.C
 extern int DataNodeSize;
@@ -462,7 +469,7 @@ extern int messageQueueOverflow;
 #define NodePoolSize 0x100
 #define FreeNodeWrap (NodePoolSize - 1)
 
-void ReportOverflow()
+static void ReportOverflow()
 {
   CmiMemoryAtomicIncrement(messageQueueOverflow);
 }
@@ -488,8 +495,8 @@ typedef struct MPSCQueueStruct
 {
   std::atomic<unsigned int> push;
   char pad1[CMI_CACHE_LINE_SIZE - sizeof(std::atomic<unsigned int>)]; // align to cache line
-  unsigned int pull;
-  char pad2[CMI_CACHE_LINE_SIZE - sizeof(unsigned int)]; // align to cache line
+  std::atomic<unsigned int> pull; // written only by the consumer, read by producers to detect a full queue
+  char pad2[CMI_CACHE_LINE_SIZE - sizeof(std::atomic<unsigned int>)]; // align to cache line
   std::atomic<uintptr_t> *nodes;
   char pad3[CMI_CACHE_LINE_SIZE - sizeof(std::atomic<uintptr_t> *)]; // align to cache line
   FreeNodePool freeNodePool;
@@ -497,16 +504,8 @@ typedef struct MPSCQueueStruct
 
 static unsigned int WrappedDifference(unsigned int push, unsigned int pull)
 {
-  unsigned int difference;
-  if(push < pull)
-  {
-    difference = (UINT_MAX - pull + push);
-  }
-  else
-  {
-    difference = push - pull;
-  }
-  return difference;
+  // Unsigned subtraction is exact modulo 2^32, including after push wraps around
+  return push - pull;
 }
 
 static int QueueFull(unsigned int push, unsigned int pull)
@@ -526,9 +525,9 @@ static int QueueFull(unsigned int push, unsigned int pull)
 /* Creates a DataNode while holds the char* to data */
 static DataNode DataNodeCreate(void)
 {
-  DataNode node = (DataNode)malloc(sizeof(char*)*DataNodeSize);
+  DataNode node = (DataNode)malloc(sizeof(std::atomic<uintptr_t>)*DataNodeSize);
   int i;
-  for(i = 0; i < DataNodeSize; ++i) node[i] = NULL;
+  for(i = 0; i < DataNodeSize; ++i) std::atomic_store_explicit(&node[i], (uintptr_t)NULL, std::memory_order_relaxed);
   return node;
 }
 
@@ -612,7 +611,7 @@ static MPSCQueue MPSCQueueCreate(void)
   MPSCQueue Q = (MPSCQueue)malloc(sizeof(struct MPSCQueueStruct));
   Q->nodes = (std::atomic<uintptr_t>*)malloc(sizeof(std::atomic<uintptr_t>)*MaxDataNodes);
   Q->freeNodePool = FreeNodePoolCreate();
-  Q->pull = 0;
+  std::atomic_store_explicit(&Q->pull, 0u, std::memory_order_relaxed);
   std::atomic_store_explicit(&Q->push, 0u, std::memory_order_relaxed);
 
   unsigned int i;
@@ -671,7 +670,8 @@ static inline DataNode get_pop_node(MPSCQueue Q, unsigned int pull_idx)
 {
   unsigned int node_idx = get_node_index(pull_idx);
 
-  return (DataNode)atomic_load_explicit(&Q->nodes[node_idx], std::memory_order_relaxed);
+  // Acquire pairs with the release in get_push_node so the NULL-initialized slots are visible
+  return (DataNode)atomic_load_explicit(&Q->nodes[node_idx], std::memory_order_acquire);
 }
 
 /* Check whether or not a node is ready to be freed */
@@ -690,20 +690,20 @@ static void check_mem_reclamation(MPSCQueue Q, unsigned int pull_idx, DataNode n
 static int MPSCQueueEmpty(MPSCQueue Q)
 {
   unsigned int push = std::atomic_load_explicit(&Q->push, std::memory_order_relaxed);
-  unsigned int pull = Q->pull;
+  unsigned int pull = std::atomic_load_explicit(&Q->pull, std::memory_order_relaxed);
   return WrappedDifference(push, pull) == 0;
 }
 
 static int MPSCQueueLength(MPSCQueue Q)
 {
   unsigned int push = std::atomic_load_explicit(&Q->push, std::memory_order_relaxed);
-  unsigned int pull = Q->pull;
+  unsigned int pull = std::atomic_load_explicit(&Q->pull, std::memory_order_relaxed);
   return (int)WrappedDifference(push, pull);
 }
 
 static char *MPSCQueueTop(MPSCQueue Q)
 {
-  unsigned int pull = Q->pull;
+  unsigned int pull = std::atomic_load_explicit(&Q->pull, std::memory_order_relaxed);
   unsigned int push = std::atomic_load_explicit(&Q->push, std::memory_order_acquire);
 
   DataNode node = get_pop_node(Q, pull);
@@ -712,13 +712,13 @@ static char *MPSCQueueTop(MPSCQueue Q)
 
   unsigned int node_pull = pull & DataNodeWrap;
 
-  char * data = node[node_pull];
+  char * data = (char *)atomic_load_explicit(&node[node_pull], std::memory_order_acquire);
   return data;
 }
 
 static char *MPSCQueuePop(MPSCQueue Q)
 {
-  unsigned int pull = Q->pull;
+  unsigned int pull = std::atomic_load_explicit(&Q->pull, std::memory_order_relaxed);
   unsigned int push = std::atomic_load_explicit(&Q->push, std::memory_order_acquire);
   if(pull == push) // If the queue is empty
     return NULL;
@@ -729,13 +729,13 @@ static char *MPSCQueuePop(MPSCQueue Q)
 
   unsigned int node_pull = pull & DataNodeWrap;
 
-  char * data = node[node_pull];
+  char * data = (char *)atomic_load_explicit(&node[node_pull], std::memory_order_acquire);
   if(data == NULL) // If a producer has not finished pushing an element we are attempting to pop
     return NULL;
 
-  node[node_pull] = NULL; //NULL the element to indicate it is available again
+  std::atomic_store_explicit(&node[node_pull], (uintptr_t)NULL, std::memory_order_relaxed); //NULL the element to indicate it is available again
 
-  Q->pull = (pull + 1);
+  std::atomic_store_explicit(&Q->pull, pull + 1, std::memory_order_release);
 
   check_mem_reclamation(Q, pull, node); //Check if we can free the node
 
@@ -745,18 +745,18 @@ static char *MPSCQueuePop(MPSCQueue Q)
 static void MPSCQueuePush(MPSCQueue Q, char *data)
 {
   unsigned int push = std::atomic_fetch_add_explicit(&Q->push, 1u, std::memory_order_release);
-  unsigned int pull = Q->pull;
+  unsigned int pull = std::atomic_load_explicit(&Q->pull, std::memory_order_acquire);
 
   while(QueueFull(push, pull)) //Block until the push index is available to push to
   {
     ReportOverflow();
 
     sched_yield();
-    pull = Q->pull;
+    pull = std::atomic_load_explicit(&Q->pull, std::memory_order_acquire);
   }
 
   DataNode node = get_push_node(Q, push);
-  node[push & DataNodeWrap] = data;
+  std::atomic_store_explicit(&node[push & DataNodeWrap], (uintptr_t)data, std::memory_order_release);
 }
 
 
@@ -1075,7 +1075,7 @@ static void MPMCQueuePush(MPMCQueue Q, void *data)
 }
 
 
-#endif /* the endif for "#if CMK_LOCKLESS_QUEUE" */
+#endif /* the endif for "#if CMK_LOCKLESS_QUEUE || CMK_LOCKLESS_PE_RECV_QUEUE" */
 
 
 /* the endif for "ifndef _PCQUEUE_" */
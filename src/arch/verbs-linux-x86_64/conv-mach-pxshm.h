@@ -1,3 +1,2 @@
 #undef CMK_USE_PXSHM
 #define CMK_USE_PXSHM 			1
-#define PXSHM_LOCK                      1
@@ -22,6 +22,11 @@ restarting of Charm++ programs. ...
     Completely changed the data file format for array elements to become
     one file for each processor. 
     Two main checkpoint/restart subroutines are greatly simplified.
+
+--- With +chkpt_stripes N, array elements are instead aggregated into N
+    shared files (arr_stripe_#.dat), optionally LZ4-compressed
+    (+chkpt_compress), each ending with an index of its element records.
+    Such checkpoints can be restarted on any number of processors.
 */
 #ifndef _CKCHECKPOINT_H
 #define _CKCHECKPOINT_H
@@ -78,6 +83,20 @@ extern bool _restarted;          // 1: if this run is after restart
 extern int _oldNumPes;           // number of processors in the last run
 extern bool _chareRestored;      // 1: if chare is restored at restart
 
+// striped disk checkpoints of array elements
+extern int _chkptStripes;        // number of shared files, 0: one file per PE
+extern bool _chkptCompress;      // LZ4-compress the element records
+
+/// Where an array element's record is in a striped checkpoint file
+struct CkChkptElementIndex {
+  CmiUInt8 id;          // element ID
+  int gid;              // index of the element's CkLocMgr group
+  CmiUInt4 rawBytes;    // size before compression, 0 if stored uncompressed
+  CmiUInt8 offset;      // of the record in the file
+  CmiUInt8 bytes;       // stored size of the record
+};
+PUPbytes(CkChkptElementIndex)
+
 enum{CK_CHECKPOINT_SUCCESS, CK_CHECKPOINT_FAILURE};
 
 class CkCheckpointStatusMsg:public CMessage_CkCheckpointStatusMsg{
@@ -10,6 +10,7 @@ array proxies, or the details of element creation (see ckarray.h).
 #define __CKLOCATION_H
 
 #include <unordered_map>
+#include "ckflathashmap.h"
 struct IndexHasher {
   public:
     size_t operator()(const CkArrayIndex& idx) const {
@@ -289,12 +290,15 @@ class CkLocMgr : public IrrGroup {
 public:
 
 typedef std::unordered_map<CkArrayID, CkArray*, ArrayIDHasher> ArrayIdMap;
-typedef std::unordered_map<CmiUInt8, int> IdPeMap;
-typedef std::unordered_map<CmiUInt8, std::vector<CkArrayMessage*> > MsgBuffer;
-typedef std::unordered_map<CkArrayIndex, std::vector<CkArrayMessage *>, IndexHasher> IndexMsgBuffer;
-typedef std::unordered_map<CkArrayIndex, std::vector<std::pair<int, bool> >, IndexHasher > LocationRequestBuffer;
-typedef std::unordered_map<CkArrayIndex, CmiUInt8, IndexHasher> IdxIdMap;
-typedef std::unordered_map<CmiUInt8, CkLocRec*> LocRecHash;
+// The per-element tables are flat open-addressing maps: they hold an entry
+// for every element (or buffered message batch), and are consulted on every
+// delivery.  Inserting into or erasing from them moves entries around.
+typedef CkFlatHashMap<CmiUInt8, int> IdPeMap;
+typedef CkFlatHashMap<CmiUInt8, std::vector<CkArrayMessage*> > MsgBuffer;
+typedef CkFlatHashMap<CkArrayIndex, std::vector<CkArrayMessage *>, IndexHasher> IndexMsgBuffer;
+typedef CkFlatHashMap<CkArrayIndex, std::vector<std::pair<int, bool> >, IndexHasher > LocationRequestBuffer;
+typedef CkFlatHashMap<CkArrayIndex, CmiUInt8, IndexHasher> IdxIdMap;
+typedef CkFlatHashMap<CmiUInt8, CkLocRec*> LocRecHash;
 
 	CkLocMgr(CkArrayOptions opts);
 	CkLocMgr(CkMigrateMessage *m);
@@ -483,6 +487,7 @@ private:
 	friend class CkLocation; //so it can call pupElementsFor
 	friend class ArrayElement;
 	friend class MemElementPacker;
+	friend class MemElementDeltaPacker;
 #if (defined(_FAULT_MLOG_) || defined(_FAULT_CAUSAL_))
 	void pupElementsFor(PUP::er &p,CkLocRec *rec,
         CkElementCreation_t type, bool create=true, int dummy=0);
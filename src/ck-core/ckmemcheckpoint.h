@@ -2,6 +2,8 @@
 #define _CK_MEM_CHECKPT_
 
 #include "CkMemCheckpoint.decl.h"
+#include <map>
+#include <memory>
 
 extern CkGroupID ckCheckPTGroupID;
 class CkArrayCheckPTReqMessage: public CMessage_CkArrayCheckPTReqMessage {
@@ -18,6 +20,12 @@ public:
 	int bud1, bud2;
 	size_t len;
 	bool cp_flag;          // true: from checkpoint, false: from recover
+	// incremental checkpointing: packData holds the changes to the previous
+	// image of baseLen bytes, which give an image of imageLen bytes
+	bool delta;
+	size_t baseLen, imageLen;
+
+	CkArrayCheckPTMessage(): delta(false), baseLen(0), imageLen(0) {}
 };
 
 
@@ -55,15 +63,28 @@ public:
 #define CkCheckPoint_inMEM   1
 #define CkCheckPoint_inDISK  2
 
+/// an in-memory checkpoint image: a full image and the deltas applied to
+/// it since, shared between the two checkpoint slots
+struct CkCheckPTImage {
+  std::shared_ptr<CkArrayCheckPTMessage> base;
+  std::vector<std::shared_ptr<CkArrayCheckPTMessage> > deltas;
+  size_t len;          // length of the image
+  size_t deltaBytes;   // total size of the deltas
+  CkCheckPTImage(): len(0), deltaBytes(0) {}
+};
+
 class CkCheckPTEntry{
-  std::vector<CkArrayCheckPTMessage *> data;
+  std::vector<CkCheckPTImage> data;
   std::string fname;
+  void updateDelta(int pointer, CkArrayCheckPTMessage *msg);
+  static CkArrayCheckPTMessage *materialize(const CkCheckPTImage &image);
 public:
   int bud1, bud2;
   int where;
   void init(int _where, int idx)
   {
-    data.resize(2, NULL);
+    data.clear();
+    data.resize(2);
     where = _where;
     if(where == CkCheckPoint_inDISK)
     {
@@ -89,7 +110,7 @@ public:
     {
       envelope *env = UsrToEnv(msg);
       CkUnpackMessage(&env);
-      data[pointer] = (CkArrayCheckPTMessage *)EnvToUsr(env);
+      msg = (CkArrayCheckPTMessage *)EnvToUsr(env);
       FILE *f = fopen(fname.c_str(),"wb");
       PUP::toDisk p(f);
       CkPupMessage(p, (void **)&msg);
@@ -103,10 +124,17 @@ public:
     {
       CmiAssert(where == CkCheckPoint_inMEM);
       CmiAssert(msg!=NULL);
-      delete data[pointer];
-      data[pointer] = msg;
       bud1 = msg->bud1;
       bud2 = msg->bud2;
+      if (msg->delta) {
+        updateDelta(pointer, msg);
+        return;
+      }
+      CkCheckPTImage &image = data[pointer];
+      image.base.reset(msg, [](CkArrayCheckPTMessage *m) { delete m; });
+      image.deltas.clear();
+      image.len = msg->len;
+      image.deltaBytes = 0;
     }
   }
   
@@ -125,15 +153,29 @@ public:
     }else
     {
       CmiAssert(where == CkCheckPoint_inMEM);
-      if (data[pointer] == NULL) {
+      const CkCheckPTImage &image = data[pointer];
+      if (!image.base) {
         CmiPrintf("[%d] recoverArrayElements: element does not have checkpoint data.", CkMyPe());
         CmiAbort("Abort!");
       }
-      return (CkArrayCheckPTMessage *)CkCopyMsg((void **)&data[pointer]);
+      if (image.deltas.empty()) {
+        void *base = image.base.get();
+        return (CkArrayCheckPTMessage *)CkCopyMsg(&base);
+      }
+      return materialize(image);
     }
   }
 };
 
+/// where an array element's data is in the last array checkpoint image of
+/// this processor, for incremental checkpointing
+struct CkCheckPTElementImage {
+  size_t offset, len;
+  std::vector<CmiUInt8> hashes;   // of the blocks of the element's data
+};
+typedef std::pair<int, CmiUInt8> CkCheckPTElementKey;   // locMgr, element ID
+typedef std::map<CkCheckPTElementKey, CkCheckPTElementImage> CkCheckPTImageMap;
+
 
 class CkMemCheckPT: public CBase_CkMemCheckPT {
 public:
@@ -167,6 +209,7 @@ public:
   void startArrayCheckpoint();
   void recvArrayCheckpoint(CkArrayCheckPTMessage *m);
   void recoverAll(CkArrayCheckPTMessage * msg, std::vector<CkGroupID> * gmap=NULL, std::vector<CkArrayIndex> * imap=NULL);
+  void reportStats(double *stats, int n);
 public:
   static CkCallback  cpCallback;
 
@@ -190,8 +233,17 @@ private:
 
     /// to use memory or disk checkpointing
   int    where;
+
+  /// layout of the last array checkpoint image sent (incremental mode)
+  CkCheckPTImageMap lastImage;
+  size_t lastImageLen;
+  bool haveLastImage;
+  /// statistics of this processor's last checkpoint
+  size_t imageBytes, sentBytes;
+  double packTime;
 private:
   void initEntry();
+  CkArrayCheckPTMessage *packIncremental();
   inline bool isMaster(int pe);
 
   void failed(int pe);
@@ -2,6 +2,7 @@
 #define _MULTICAST
 
 #include "pup.h"
+#include <unordered_map>
 class mCastEntry;
 
 class multicastSetupMsg;
@@ -24,6 +25,32 @@ extern void CkGetSectionInfo(CkSectionInfo &id, void *msg);
 
 class CProxySection_ArrayElement;
 
+/// Counts of spanning tree builds done by one CkMulticastMgr branch, as seen by section roots
+struct CkMulticastStats {
+    /// Spanning trees built from scratch with setup messages
+    unsigned long treesBuilt;
+    /// Sections that reused a cached tree instead of building one
+    unsigned long treeCacheHits;
+    /// Trees retired and rebuilt after section members migrated
+    unsigned long rebuilds;
+    /// Rebuilds that were skipped because no member had moved to another PE
+    unsigned long rebuildsSkipped;
+    /// setup and recvCookie messages exchanged to build the trees
+    unsigned long setupMsgs;
+    /// Trees whose build completed, and the time between the root starting and finishing them
+    unsigned long treesReady;
+    double setupTime, maxSetupTime;
+
+    CkMulticastStats() { reset(); }
+    void reset() {
+        treesBuilt = treeCacheHits = rebuilds = rebuildsSkipped = setupMsgs = treesReady = 0;
+        setupTime = maxSetupTime = 0.0;
+    }
+    double meanSetupTime() const { return treesReady ? setupTime/treesReady : 0.0; }
+    void print() const;
+};
+PUPbytes(CkMulticastStats)
+
 /**
  * A multicast manager group that is a CkDelegateMgr. Can manage all sections of different 
  * chare arrays, so all functions need a CkSectionInfo parameter to tell CkMulticastMgr which 
@@ -35,22 +62,35 @@ class CkMulticastMgr: public CkDelegateMgr
         int dfactor;           // default spanning tree branch factor for this CkMulticastMgr, can be negative
         unsigned int split_size;
         unsigned int split_threshold;
+        /// Reuse the spanning tree of an earlier section with the same members
+        bool cacheTrees;
+        /// Root vertices of the cached trees, by membership hash
+        std::unordered_multimap<size_t, mCastEntry *> treeCache;
+        /// Id for the next section that uses a cached tree
+        int nextSectionId;
+        CkMulticastStats stats;
         
     public:
         // ------------------------- Cons/Des-tructors ------------------------
-        CkMulticastMgr(CkMigrateMessage *m)  {}
-        CkMulticastMgr(int _dfactor = 2, unsigned int _split_size = 8192, unsigned int _split_threshold = 8192):
-            dfactor(_dfactor),
-            split_size(_split_size),
-            split_threshold(_split_threshold) {}
+        CkMulticastMgr(CkMigrateMessage *m);
+        CkMulticastMgr(int _dfactor = 2, unsigned int _split_size = 8192, unsigned int _split_threshold = 8192);
         bool useDefCtor(void){ return true; }
         void pup(PUP::er &p){ 
 		CkDelegateMgr::pup(p);
 		p|dfactor;
 		p|split_size;
 		p|split_threshold;
+		p|cacheTrees;
 	}
 
+        // ------------------------- Spanning Tree Cache ------------------------
+        /// Let array sections rooted here with the same array, members and branching factor share one spanning tree
+        void setTreeCaching(bool on) { cacheTrees = on; }
+        bool isTreeCaching() const { return cacheTrees; }
+        /// Tree build counts for the sections rooted on this PE
+        const CkMulticastStats &getStats() const { return stats; }
+        void resetStats() { stats.reset(); }
+
         // ------------------------- Spanning Tree Setup ------------------------
         /// Stuff section member info into CkSectionInfo and call initCookie for the tree building
         void setSection(CkSectionInfo &id, CkArrayID aid, CkArrayIndex *, int n);
@@ -66,6 +106,8 @@ class CkMulticastMgr: public CkDelegateMgr
         void recvCookie(CkSectionInfo sid, CkSectionInfo child);
         /// Notify my tree parent (if any) that I am are ready
         void childrenReady(mCastEntry *entry);
+        /// Pass on the multicasts and reductions that waited for an entry to become ready
+        void releasePendingMsgs(mCastEntry *entry);
         // ------------------------- Spanning Tree Teardown ------------------------
         /// entry Marks tree as obsolete, releases buffered msgs and propagates the call to children
         void teardown(CkSectionInfo s);
@@ -89,7 +131,7 @@ class CkMulticastMgr: public CkDelegateMgr
         /// entry Accept a redn msg from a child in the spanning tree
         void recvRedMsg(CkReductionMsg *msg);
         /// entry Update the current completed redn num to input value
-        void updateRedNo(mCastEntryPtr, int red);
+        void updateRedNo(CkSectionInfo s, int red);
         /// Configure a client to accept the reduction result
         void setReductionClient(CProxySection_ArrayElement &, redClientFn fn,void *param=NULL);
         /// Configure a client to accept the reduction result
@@ -136,6 +178,18 @@ class CkMulticastMgr: public CkDelegateMgr
         void sendToSection(CkDelegateData *pd,int ep,void *m, CkSectionID *sid, int opts);
         /// Mark old cookie spanning tree as old and build a new one
         void resetCookie(CkSectionInfo sid);
+        /// Find a ready-to-use cached tree for these section members, or NULL
+        mCastEntry *findCachedTree(CkArrayID aid, const CkArrayIndex *al, int count, int bfactor);
+        void addCachedTree(mCastEntry *entry);
+        void removeCachedTree(mCastEntry *entry);
+        /// Put a new section root on the cached tree for its members, building the tree if needed
+        void attachTree(mCastEntry *entry);
+        /// The view of a shared tree vertex for a section, created when the section first reaches it
+        mCastEntry *sectionView(mCastEntry *vertex, int id);
+        /// Copy the children, parent and root of a ready vertex into a view of it
+        void readyView(mCastEntry *view);
+        /// Move a section root from its rebuilt shared tree to the current tree for its members
+        mCastEntry *moveView(mCastEntry *entry);
         ///
         void releaseBufferedReduceMsgs(mCastEntryPtr entry);
         /// Release buffered redn msgs from later reductions which arrived early (out of order)
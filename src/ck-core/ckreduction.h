@@ -255,6 +255,10 @@ public:
 	// reducerType.  Must be called in the same order on every node.
 	static reducerType addReducer(reducerFn fn, bool streamable=false, const char* name=NULL);
 
+	//Look up the function that combines contributions of the given
+	// reducerType (e.g. to time or test a reducer outside a reduction).
+	static reducerFn getReducerFn(reducerType type);
+
 private:
 	friend class CkReductionMgr;
  	friend class CkNodeReductionMgr;
@@ -626,6 +630,11 @@ class NodeGroup : public CkNodeReductionMgr {
 };
 
 
+// Whether the PEs of an SMP node combine their reduction results in
+// shared memory (off unless +nodeCombineInReduction is given)
+extern bool _isNodeCombineInRed;
+struct CkNodeReductionSlots;
+
 class CkReductionMgr : public CkGroupInitCallback {
 public:
         CProxy_CkReductionMgr thisProxy;
@@ -675,6 +684,8 @@ public:
 	void MigrantDied(CkReductionNumberMsg *m);
 
 	void RecvMsg(CkReductionMsg *m);
+	//Sent to the first PE of a node with the combined result of its other PEs
+	void RecvNodeMsg(CkReductionMsg *m);
   void AddToInactiveList(CkReductionInactiveMsg *m);
 
 // simple barrier for FT
@@ -752,6 +763,8 @@ private:
 	CkMsgQ<CkReductionMsg> futureMsgs;
 	//Remote messages queued for future reductions (sent to us too early)
 	CkMsgQ<CkReductionMsg> futureRemoteMsgs;
+	//Node-combined messages queued for future reductions
+	CkMsgQ<CkReductionMsg> futureNodeMsgs;
 
 	CkMsgQ<CkReductionMsg> finalMsgs;
   std::map<int, int> inactiveList;
@@ -778,6 +791,12 @@ private:
 
 	void init_TopoTree();
 	void init_BinaryTree();
+
+	//Shared slots where the PEs of this SMP node other than the first
+	// combine their results (NULL when contributions are sent directly)
+	CkNodeReductionSlots *nodeSlots;
+	void init_NodeCombine();
+	void depositNodeContribution(CkReductionMsg *m);
 	enum {TREE_WID=2};
 	int treeRoot(void);//Root PE
 
@@ -40,6 +40,7 @@ namespace SDAG {
 #include <vector>
 #include <list>
 #include <unordered_set>
+#include <unordered_map>
 #include <memory>
 
 #include <pup_stl.h>
@@ -195,6 +196,9 @@ namespace SDAG {
   struct Buffer : public PUP::able {
     int entry;
     Closure* cl;
+    // positions in the owning Dependency's arrival list and refnum index;
+    // not migrated, rebuilt by Dependency::pup on unpack
+    std::list<Buffer*>::iterator pos, refPos;
 #if USE_CRITICAL_PATH_HEADER_ARRAY
     MergeablePathHistory *savedPath;
 #endif
@@ -248,13 +252,16 @@ namespace SDAG {
   };
 
   struct Dependency {
+    typedef std::unordered_map<CMK_REFNUM_TYPE, std::list<Buffer*> > RefnumIndex;
+
     std::vector<std::list<int> > entryToWhen;
     std::vector<std::list<Continuation*> > whenToContinuation;
 
-    // entry -> lst of buffers
-    // @todo this will have sequential lookup time for specific reference
-    // numbers
+    // entry -> list of buffers, in arrival order
     std::vector<std::list<Buffer*> > buffer;
+    // entry -> refnum -> buffers carrying that refnum, in arrival order, so
+    // that matching a specific reference number does not scan the buffer
+    std::vector<RefnumIndex> refnumBuffer;
 
     int curSpeculationIndex;
 
@@ -263,12 +270,22 @@ namespace SDAG {
       p | entryToWhen;
       p | buffer;
       p | whenToContinuation;
+      if (p.isUnpacking()) {
+        refnumBuffer.clear();
+        refnumBuffer.resize(buffer.size());
+        for (size_t entry = 0; entry < buffer.size(); entry++) {
+          std::list<Buffer*>& lst = buffer[entry];
+          for (std::list<Buffer*>::iterator iter = lst.begin(); iter != lst.end(); ++iter)
+            indexBuffer(iter);
+        }
+      }
     }
 
     Dependency(int numEntries, int numWhens)
       : entryToWhen(numEntries)
       , whenToContinuation(numWhens)
       , buffer(numEntries)
+      , refnumBuffer(numEntries)
       , curSpeculationIndex(0)
       { }
 
@@ -309,9 +326,20 @@ namespace SDAG {
       lst.remove(c);
     }
 
+    // record the position of a buffer already in the arrival list and add it
+    // to the refnum index
+    void indexBuffer(std::list<Buffer*>::iterator iter) {
+      Buffer* buf = *iter;
+      buf->pos = iter;
+      if (buf->cl->hasRefnum) {
+        std::list<Buffer*>& lst = refnumBuffer[buf->entry][buf->cl->refnum];
+        buf->refPos = lst.insert(lst.end(), buf);
+      }
+    }
+
     Buffer* pushBuffer(int entry, Closure *cl) {
       Buffer* buf = new Buffer(entry, cl);
-      buffer[entry].push_back(buf);
+      indexBuffer(buffer[entry].insert(buffer[entry].end(), buf));
       return buf;
     }
 
@@ -351,12 +379,19 @@ namespace SDAG {
     }
 
     Buffer* tryFindMessage(int entry, bool hasRef, CMK_REFNUM_TYPE refnum, std::unordered_set<Buffer*>* ignore) {
-      // @todo sequential lookup for buffer with reference number or ignore set
-      for (std::list<Buffer*>::iterator iter = buffer[entry].begin();
-           iter != buffer[entry].end();
+      std::list<Buffer*>* lst = &buffer[entry];
+      if (hasRef) {
+        RefnumIndex::iterator bucket = refnumBuffer[entry].find(refnum);
+        if (bucket == refnumBuffer[entry].end())
+          return 0;
+        lst = &bucket->second;
+      }
+      // the ignore set only holds buffers already matched by earlier clauses
+      // of the same when, so this stops after at most that many steps
+      for (std::list<Buffer*>::iterator iter = lst->begin();
+           iter != lst->end();
            ++iter) {
-        if ((!hasRef || ((*iter)->cl->hasRefnum && (*iter)->cl->refnum == refnum)) &&
-            (!ignore || ignore->find(*iter) == ignore->end()))
+        if (!ignore || ignore->find(*iter) == ignore->end())
           return *iter;
       }
       return 0;
@@ -370,7 +405,15 @@ namespace SDAG {
     }
 
     void removeMessage(Buffer *buf) {
-      buffer[buf->entry].remove(buf);
+      buffer[buf->entry].erase(buf->pos);
+      if (buf->cl->hasRefnum) {
+        RefnumIndex& index = refnumBuffer[buf->entry];
+        RefnumIndex::iterator bucket = index.find(buf->cl->refnum);
+        CkAssert(bucket != index.end());
+        bucket->second.erase(buf->refPos);
+        if (bucket->second.empty())
+          index.erase(bucket);
+      }
     }
 
     int getAndIncrementSpeculationIndex() {
@@ -338,6 +338,7 @@ public:
 #if (defined(_FAULT_MLOG_) || defined(_FAULT_CAUSAL_))
 	int step;
 #endif
+  bool compact;		// pup objData and commData compactly (+LBCompressStats)
 
 public:
   CLBStatsMsg(int osz, int csz);
@@ -350,7 +351,7 @@ public:
 #if CMK_LB_CPUTIMER
 		 total_cputime(0.0), bg_cputime(0.0),
 #endif
-		 commData(NULL), avail_vector(NULL), next_lb(0) {}
+		 commData(NULL), avail_vector(NULL), next_lb(0), compact(false) {}
   ~CLBStatsMsg();
   void pup(PUP::er &p);
 }; 
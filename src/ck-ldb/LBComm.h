@@ -9,6 +9,8 @@
 #include "converse.h"
 #include "lbdb.h"
 
+#include <vector>
+
 class LBObj; //Forward declaration
 template <class T> class CkVec; //Forward declaration
 
@@ -95,22 +97,58 @@ private:
   int n_bytes;
 };
 
+// object to object edge of the compact store; both ends are 32-bit ids
+// handed out by the table's object index
+struct LBCommEdge {
+  CmiUInt8 key;			// (sender id << 32) | receiver id
+  int destObjProc;
+  int n_messages;
+  int n_bytes;
+};
+
 class LBCommTable {
 public:
 
   LBCommTable() {
     NewTable(initial_sz);
+    edges = 0;
+    NewEdges(edge_initial_sz);
+    objSlots.assign(obj_initial_sz, -1);
+    period = 0;
+    last_src_valid = false;
+    SetSampleRate(1);
   };
 
   ~LBCommTable() {
     delete [] set;
     delete [] state;
+    delete [] edges;
   };
 
+  // Object to object messages, the common case, go to a compact edge store
+  // instead of the generic table.
+  void AddObjMessage(const LDObjHandle &src, const LDOMid &destOM,
+      CmiUInt8 destObj, int destObjProc, int bytes, int nMsgs=1);
+
+  // Start a new statistics period. The storage is kept, sized for a period
+  // like the last one, and objects not seen in the last period are dropped
+  // from the index once they make up most of it.
+  void Clear();
+
+  // Record 1 in rate messages, chosen at random, each counted rate times
+  void SetSampleRate(int rate);
+  // The weight to record the next message with: 0 if it is not sampled
+  inline int SampleWeight() {
+    if (sample_rate <= 1) return 1;
+    if (--sample_skip > 0) return 0;
+    sample_skip = NextSkip();
+    return sample_rate;
+  }
+
   LBCommData* HashInsert(const LBCommData &data);
   LBCommData* HashInsertUnique(const LBCommData &data);
   LBCommData* HashSearch(const LBCommData &data);
-  int CommCount() { return in_use; };
+  int CommCount() { return in_use + edges_in_use; };
   void GetCommData(LDCommData* data);
   void GetCommInfo(int& bytes, int& msgs, int& withinpebytes,
       int& outsidepebytes, int& num_nghbor, int& hops, int& hopbytes);
@@ -127,18 +165,46 @@ private:
   
   void Resize();
 
+  void NewEdges(int _sz);
+  void RehashEdges(int _sz);
+  CmiUInt4 ObjectId(const LDOMid &om, CmiUInt8 obj);
+  void RehashObjects(int _sz);
+  int NextSkip();
+
 #ifdef __BIGSIM__
-  enum { initial_sz = 1 };
+  enum { initial_sz = 1, edge_initial_sz = 4, obj_initial_sz = 4 };
 #else
-  enum { initial_sz = 500 };
+  enum { initial_sz = 500, edge_initial_sz = 512, obj_initial_sz = 256 };
 #endif
   enum TableState : uint8_t { nil, InUse } ;
   LBCommData* set;
   TableState* state;
   int cur_sz;
   int in_use;
+
+  // compact store: open addressing with linear probing, power of 2 sizes
+  LBCommEdge* edges;
+  int edge_sz;
+  int edges_in_use;
+  std::vector<LDObjKey> objKeys;	// object id -> key
+  std::vector<int> objStamp;		// last period the object was seen in
+  std::vector<int> objSlots;		// hash slot -> object id, -1 if free
+  int period;
+  LDObjKey last_src;			// senders come in runs, cache the last
+  CmiUInt4 last_src_id;
+  bool last_src_valid;
+
+  int sample_rate;
+  int sample_skip;
+  double sample_logq;			// log(1 - 1/sample_rate)
+  CmiUInt8 sample_rng;
 public:
-  int useMem() { return cur_sz*(sizeof(LBCommData) + sizeof(TableState)) + sizeof(LBCommTable); }
+  int useMem() {
+    return cur_sz*(sizeof(LBCommData) + sizeof(TableState))
+      + edge_sz*sizeof(LBCommEdge)
+      + objKeys.capacity()*(sizeof(LDObjKey) + sizeof(int))
+      + objSlots.size()*sizeof(int) + sizeof(LBCommTable);
+  }
 };
 
 
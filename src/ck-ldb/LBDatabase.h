@@ -40,6 +40,9 @@ private:
   double _lb_targetRatio; // Specifies the target load ratio for LBs that aim for a particular load ratio
   int _lb_metaLbOn;
   char* _lb_metaLbModelDir;
+  int _lb_compressStats;	// compact encoding of stats sent to the central PE
+  int _lb_commThreshold;	// only send comm edges of at least this many bytes
+  int _lb_commSample;		// record 1 in this many messages
 
  public:
   CkLBArgs() {
@@ -59,6 +62,9 @@ private:
     _lb_targetRatio = 1.05;
     _lb_metaLbOn = 0;
     _lb_metaLbModelDir = nullptr;
+    _lb_compressStats = 0;
+    _lb_commThreshold = 0;
+    _lb_commSample = 1;
   }
   inline double & lbperiod() { return _autoLbPeriod; }
   inline int & debug() { return _lb_debug; }
@@ -82,6 +88,9 @@ private:
   inline double & targetRatio() { return _lb_targetRatio; }
   inline int & metaLbOn() {return _lb_metaLbOn;}
   inline char*& metaLbModelDir() { return _lb_metaLbModelDir; }
+  inline int & compressStats() { return _lb_compressStats; }
+  inline int & commThreshold() { return _lb_commThreshold; }
+  inline int & commSample() { return _lb_commSample; }
 };
 
 extern CkLBArgs _lb_args;
@@ -0,0 +1,82 @@
+/**
+ * \addtogroup CkLdb
+*/
+/*@{*/
+
+/*
+  Parallel loops for centralized strategies. A strategy runs on one PE
+  while the other PEs of its node wait for its decision; when a node-level
+  loop runtime such as CkLoop is initialized, it registers itself here and
+  LBParallelFor spreads the loop over those PEs. Otherwise the loops run
+  serially.
+*/
+
+#ifndef _LBPARALLEL_H_
+#define _LBPARALLEL_H_
+
+#include <algorithm>
+#include <vector>
+
+/// Work on the iterations [first, last] of a loop
+typedef void (*LBLoopFn)(int first, int last, void *param);
+/// Run fn over [0, n) in nchunks chunks and wait for all of them
+typedef void (*LBParallelForImpl)(int nchunks, int n, LBLoopFn fn, void *param);
+
+/// Called by the loop runtime of a node; width is the number of PEs it uses
+void LBRegisterParallelFor(LBParallelForImpl impl, int width);
+/// Number of PEs LBParallelFor runs on, 1 if none is registered
+int LBParallelWidth();
+/// Run fn over [0, n), in chunks of at least grain iterations
+void LBParallelFor(int n, LBLoopFn fn, void *param, int grain = 1024);
+
+template <class T, class Compare>
+struct LBSortArgs {
+  T *data;
+  size_t n;
+  int nchunks;
+  size_t width;       // chunks per sorted run
+  Compare *comp;
+  size_t bound(int c) const { return (size_t)c >= (size_t)nchunks ? n : n * c / nchunks; }
+};
+
+template <class T, class Compare>
+void LBSortChunks(int first, int last, void *param)
+{
+  LBSortArgs<T, Compare> &a = *(LBSortArgs<T, Compare> *)param;
+  for (int c = first; c <= last; c++)
+    std::sort(a.data + a.bound(c), a.data + a.bound(c+1), *a.comp);
+}
+
+template <class T, class Compare>
+void LBMergeRuns(int first, int last, void *param)
+{
+  LBSortArgs<T, Compare> &a = *(LBSortArgs<T, Compare> *)param;
+  for (int r = first; r <= last; r++) {
+    size_t c = 2 * a.width * r;
+    if (c + a.width >= (size_t)a.nchunks) continue;
+    std::inplace_merge(a.data + a.bound(c), a.data + a.bound(c + a.width),
+                       a.data + a.bound(c + 2 * a.width), *a.comp);
+  }
+}
+
+/// std::sort on the PEs of LBParallelFor: the chunks are sorted
+/// concurrently, then merged pairwise
+template <class T, class Compare>
+void LBParallelSort(std::vector<T> &v, Compare comp, size_t grain = 16384)
+{
+  int nchunks = std::min((size_t)LBParallelWidth(), v.size() / grain);
+  if (nchunks <= 1) {
+    std::sort(v.begin(), v.end(), comp);
+    return;
+  }
+  LBSortArgs<T, Compare> a = { v.data(), v.size(), nchunks, 1, &comp };
+  LBParallelFor(nchunks, LBSortChunks<T, Compare>, &a, 1);
+  for (; a.width < (size_t)nchunks; a.width *= 2) {
+    int nruns = (nchunks + 2 * a.width - 1) / (2 * a.width);
+    LBParallelFor(nruns, LBMergeRuns<T, Compare>, &a, 1);
+  }
+}
+
+#endif /* _LBPARALLEL_H_ */
+
+/*@}*/
@@ -10,10 +10,14 @@
 #include "ckheap.h"
 #include "CentralLB.h"
 
+#include <set>
+#include <utility>
+#include <vector>
+
 class Refiner {
 public:
   Refiner(double _overload) { 
-    overLoad = _overload; computes=0; processors=0; 
+    overLoad = _overload; computes=0; processors=0; moveLogValid=false;
   };
   ~Refiner() {}
 
@@ -25,6 +29,12 @@ public:
   double computeMax();
 
 protected:
+  struct CreateArgs {
+    Refiner *refiner;
+    BaseLB::LDStats *stats;
+    int *procs;
+  };
+  static void createComputes(int first, int last, void *param);
   void create(int count, BaseLB::LDStats* stats, int* cur_p);
   virtual int refine();
   int multirefine(bool reset = 1);
@@ -36,6 +46,27 @@ protected:
   bool isLight(processorInfo *p);
   void removeComputes();
 
+  // Migratable computes of one processor ordered by load (ties by Id), so
+  // the largest compute that still fits on a receiver is a binary search.
+  struct LoadLess {
+    bool operator()(const computeInfo *a, const computeInfo *b) const {
+      return a->load < b->load || (a->load == b->load && a->Id < b->Id);
+    }
+  };
+  typedef std::set<computeInfo *, LoadLess> LoadSortedSet;
+  void buildMigratables();
+  void moveCompute(computeInfo *c, processorInfo *from, processorInfo *to);
+  void undoMoves();
+  void syncComputeSets();
+
+  std::vector<LoadSortedSet> migratables;
+  // Moves made by refine() since multirefine()'s snapshot, as (compute,
+  // from PE), and the processor loads at the snapshot; a reset rolls these
+  // back instead of rebuilding every processor's computeSet.
+  std::vector<std::pair<computeInfo *, int> > moveLog;
+  std::vector<double> savedComputeLoad;
+  bool moveLogValid;
+
   double overLoad;
   double averageLoad;
   int P;
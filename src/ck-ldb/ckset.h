@@ -29,6 +29,7 @@ public:
  Set();
  ~Set();
  void insert(InfoRecord *);
+ void insertNew(InfoRecord *); // caller guarantees the record is absent
  int find(InfoRecord *) ;
  void remove(InfoRecord *);
  void myRemove(listNode **n, InfoRecord *r);
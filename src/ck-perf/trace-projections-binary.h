@@ -0,0 +1,178 @@
+/**
+ * \addtogroup CkPerf
+*/
+/*@{*/
+
+/*
+  Compact, seekable projections logs (+compact-trace).
+
+  The records are the same as in the ASCII logs (LogEntry::pup decides
+  which fields an event has), but each field is stored as a varint and
+  timestamps are delta-encoded. Records carry no type information of their
+  own: each names a "shape", the run-length encoded sequence of field kinds
+  it consists of, defined the first time it is used in a block. This keeps
+  the files readable without the .sts file or the Charm++ runtime, and lets
+  the reader reproduce the ASCII records exactly.
+
+  File layout (integers in the header, index and trailer are little-endian):
+
+    "PROJBLOG" u32 version
+    blocks, each a sequence of items starting with a block start:
+      varint 0, varint base time      block start; resets the time base
+                                      and the shape table
+      varint 1, varint n, n x (u8 kind, varint count)
+                                      defines the next shape of the block
+      varint 2+s, field values        a record of shape s
+    index, one entry per block:
+      u64 offset, i64 min time, i64 max time, u64 records
+    trailer:
+      u64 index offset, u64 blocks, u64 records, "PROJBIDX"
+
+  Field values by kind: CHAR and UBYTE are raw bytes, SIGNED values are
+  zigzag varints, UNSIGNED values varints, FLOAT and DOUBLE raw IEEE values
+  in host byte order, TIME the zigzag varint difference from the previous
+  TIME in the block, and RELTIME (receive and end times) the zigzag varint
+  difference from the latest TIME, normally the one of its own record.
+  Times are in microseconds.
+
+  The index is only written when the log is closed; without it (e.g. after
+  a crash) the blocks can still be read sequentially.
+
+  This header and trace-projections-binary.C do not depend on the rest of
+  Charm++, so analysis tools can read the logs with ProjLogReader.
+*/
+
+#ifndef _TRACE_PROJECTIONS_BINARY_H
+#define _TRACE_PROJECTIONS_BINARY_H
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#define PROJLOG_MAGIC         "PROJBLOG"
+#define PROJLOG_INDEX_MAGIC   "PROJBIDX"
+#define PROJLOG_VERSION       1
+#define PROJLOG_BLOCK_EVENTS  4096   // records per indexed block
+#define PROJLOG_TRAILER_SIZE  32
+
+/// The kinds of fields a record can hold
+enum ProjLogKind {
+  PROJLOG_CHAR,       // printed as a character
+  PROJLOG_UBYTE,      // printed as a number without a leading blank
+  PROJLOG_SIGNED,
+  PROJLOG_UNSIGNED,
+  PROJLOG_FLOAT,
+  PROJLOG_DOUBLE,
+  PROJLOG_TIME,       // event timestamp
+  PROJLOG_RELTIME,    // another timestamp of the same event
+  PROJLOG_NUM_KINDS
+};
+
+/// One field of a record
+struct ProjLogField {
+  unsigned char kind;
+  unsigned long long u;   // integer kinds, two's complement for SIGNED
+  double d;               // FLOAT and DOUBLE
+};
+
+/// A decoded record
+class ProjLogEvent {
+  public:
+    int type;          // the event type (CREATION, BEGIN_PROCESSING, ...)
+    long long time;    // the event timestamp in microseconds, -1 if none
+    std::vector<ProjLogField> fields;   // all fields, including the type
+
+    ProjLogEvent() : type(-1), time(-1) {}
+    /// Write the record exactly as the ASCII log would have it
+    void writeText(FILE *f) const;
+};
+
+/// One indexed block of a log
+struct ProjLogBlock {
+  unsigned long long offset;
+  long long minTime, maxTime;
+  unsigned long long numEvents;
+};
+
+/// Encodes records into a log; the fields of a record are added one at a
+/// time and written by endEvent.
+class ProjLogEncoder {
+  public:
+    ProjLogEncoder(unsigned int blockEvents = PROJLOG_BLOCK_EVENTS);
+
+    void writeFileHeader(FILE *f);
+    void add(ProjLogKind kind, unsigned long long value);
+    void addFloat(float value);
+    void addDouble(double value);
+    void endEvent(FILE *f);
+    void writeIndex(FILE *f);
+
+    unsigned long long bytesWritten() const { return offset; }
+    unsigned long long eventsWritten() const { return numEvents; }
+
+  private:
+    unsigned int blockEvents;
+    unsigned long long offset;      // bytes of the log written so far
+    unsigned long long numEvents;
+    std::vector<ProjLogBlock> blocks;
+    long long prevTime;
+    std::unordered_map<std::string, int> shapes;   // of the current block
+    // the record being built
+    std::string shape, values;
+    unsigned char lastKind;
+    unsigned long long lastCount;
+    unsigned int shapeRuns;
+    long long eventTime;    // TIME of the record, -1 before it is added
+    long long blockBase;    // latest TIME before the record
+    bool blockStart;        // the record starts a new block
+    bool blockTimed;        // the current block has seen a TIME
+
+    void put(FILE *f, const std::string &s);
+    void addKind(ProjLogKind kind);
+    void endRun();
+};
+
+/// Streams the records of a compact log
+class ProjLogReader {
+  public:
+    ProjLogReader() : f(NULL), totalEvents(0), endOfData(0), pos(0), curBlock(-1), prevTime(0) {}
+    ~ProjLogReader() { close(); }
+
+    /// Open a log; false if it is not a compact projections log
+    bool open(const char *fname);
+    void close();
+
+    /// The block index (empty if the log was not closed properly)
+    bool hasIndex() const { return !blocks.empty(); }
+    const std::vector<ProjLogBlock> &getBlocks() const { return blocks; }
+    unsigned long long numEvents() const { return totalEvents; }
+
+    /// Continue reading at the start of the given block
+    bool seekBlock(size_t b);
+    /// Continue reading at the first block that may hold events at or
+    /// after time t (microseconds)
+    bool seekTime(long long t);
+    /// Index of the block of the last record read
+    long long currentBlock() const { return curBlock; }
+
+    /// Read the next record; false at the end of the log
+    bool next(ProjLogEvent &e);
+
+  private:
+    FILE *f;
+    std::vector<ProjLogBlock> blocks;
+    unsigned long long totalEvents;
+    unsigned long long endOfData;   // offset of the index, or file size
+    unsigned long long pos;         // offset of the next byte to read
+    long long curBlock;
+    long long prevTime;
+    std::vector<std::vector<std::pair<unsigned char, unsigned long long> > > shapes;
+
+    bool readBytes(void *p, size_t n);
+    bool readVarint(unsigned long long &v);
+    bool readIndex();
+};
+
+/*@}*/
+#endif
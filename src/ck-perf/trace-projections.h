@@ -20,6 +20,17 @@
 #endif
 
 #include "pup.h"
+#include "trace-projections-binary.h"
+
+/* Full log buffers are written in the background: by one writer thread per
+   process on SMP builds, and with POSIX asynchronous I/O elsewhere. */
+#if CMK_SMP && !defined(_WIN32)
+#define PROJ_WRITER_THREAD 1
+#include <pthread.h>
+#elif CMK_HAS_AIO && !defined(_WIN32)
+#define PROJ_WRITER_AIO 1
+#include <aio.h>
+#endif
 
 #define PROJECTION_VERSION  "10.0"
 
@@ -251,10 +262,13 @@ class LogPool {
   friend class KMeansBOC;
 #endif  //PROJ_ANALYSIS
   friend class controlPointManager;
+  friend class ProjLogWriter;
   private:
     bool writeData;
     bool writeSummaryFiles;
     bool binary;
+    bool compact;       // indexed, delta-encoded binary logs (+compact-trace)
+    bool compactText;   // also write the ASCII logs (+compact-trace-text)
     bool hasFlushed;
     bool headerWritten;
     bool fileCreated;
@@ -267,6 +281,17 @@ class LogPool {
     int numPhases;
     int nSubdirs;
     LogEntry *pool;
+    bool syncFlush;     // write full buffers on the PE itself
+#if PROJ_WRITER_THREAD
+    LogEntry *spare;    // second buffer, owned by the writer while inFlight
+    bool inFlight;      // protected by the ProjLogWriter lock
+#elif PROJ_WRITER_AIO
+    struct aiocb aioReq;
+    char *aioBuf;       // formatted entries of the pending aio_write
+#endif
+    ProjLogEncoder *encoder;   // state of the compact log across flushes
+    FILE *textfp;       // ASCII copy of the compact log (+compact-trace-text)
+    PUP::er *textp;
     FILE *fp;
     FILE *deltafp;
     FILE *stsfp;
@@ -314,13 +339,21 @@ class LogPool {
     long long statisTotalMemAlloc;
     long long statisTotalMemFree;
 
-    void writeHeader();
+    void writeHeader(UInt count);
+    PUP::er *createPUPer(int writedelta);
+    void writeEntries(PUP::er &p, LogEntry *entries, UInt n);
+    void writeEntry(PUP::er &p, LogEntry &entry);
+    void writeBuffer(LogEntry *entries, UInt n);
+    bool writeLogInBackground();
+    bool waitForWriter();
 
   public:
     LogPool(char *pgm);
     ~LogPool();
     void setBinary(int b) { binary = (b!=0); }
+    void setCompact(int c, int text=0);
     void setNumSubdirs(int n) { nSubdirs = n; }
+    void setSyncFlush(int s) { syncFlush = (s!=0); }
     void setWriteSummaryFiles(int n) { writeSummaryFiles = (n!=0)? true : false;}
 #if CMK_USE_ZLIB
     void setCompressed(int c) { compressed = c; }
@@ -581,6 +614,22 @@ class fromProjectionsFile : public fromTextFile {
   fromProjectionsFile(FILE *f_) :fromTextFile(f_) {}
 };
 
+/// Encodes log entries for compact logs; the comments of LogEntry::pup
+/// tell which fields are timestamps.
+class toProjectionsCompact : public PUP::er {
+  ProjLogEncoder &enc;
+  FILE *f;
+  ProjLogKind timeKind;   // kind of the next field, if it is a timestamp
+ protected:
+  virtual void bytes(void *p,size_t n,size_t itemSize,dataType t);
+ public:
+  toProjectionsCompact(ProjLogEncoder &e, FILE *f_)
+    :er(IS_PACKING|IS_COMMENTS), enc(e), f(f_), timeKind(PROJLOG_NUM_KINDS) {}
+  virtual void comment(const char *message);
+  /// Write the entry whose fields were just pupped
+  void endEntry() { enc.endEvent(f); }
+};
+
 #if CMK_USE_ZLIB
 class toProjectionsGZFile : public PUP::er {
   gzFile f;
@@ -138,10 +138,13 @@ class TraceProjectionsBOC : public CBase_TraceProjectionsBOC {
   double analysisStartTime;
   int endPe;                          // end PE which calls CkExit()
   int          flush_count;
+  int          blocked_flush_count;
+  double       flush_time;
+  long long    flushed_events;
   std::set<int> list;
  public:
- TraceProjectionsBOC(bool _findOutliers, bool _findStartTime) : findOutliers(_findOutliers), findStartTime(_findStartTime), parModulesRemaining(0), endPe(-1), flush_count(0) {};
- TraceProjectionsBOC(CkMigrateMessage *m):CBase_TraceProjectionsBOC(m), parModulesRemaining(0), endPe(-1), flush_count(0) {};
+ TraceProjectionsBOC(bool _findOutliers, bool _findStartTime) : findOutliers(_findOutliers), findStartTime(_findStartTime), parModulesRemaining(0), endPe(-1), flush_count(0), blocked_flush_count(0), flush_time(0.0), flushed_events(0) {};
+ TraceProjectionsBOC(CkMigrateMessage *m):CBase_TraceProjectionsBOC(m), parModulesRemaining(0), endPe(-1), flush_count(0), blocked_flush_count(0), flush_time(0.0), flushed_events(0) {};
 
   void traceProjectionsParallelShutdown(int);
   void startTimeAnalysis();
@@ -157,7 +160,8 @@ class TraceProjectionsBOC : public CBase_TraceProjectionsBOC {
 
   void ccsOutlierRequest(CkCcsRequestMsg *);
 
-  void flush_warning(int pe);
+  void flush_warning(int pe, bool blocked, double flushTime, int nEvents);
   void print_warning();
+  void writeFlushStats(FILE *stsfp);
 };
 #endif
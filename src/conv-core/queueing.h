@@ -114,10 +114,46 @@ typedef struct prioq1_struct
 #endif
 */
 
+/**
+   A bucket in an intprioq_struct: a deque of void* pointers that share
+   one int or long priority.  The priority is kept as a single integer
+   key so buckets can be found and ordered without comparing bitvectors.
+*/
+typedef struct intprioqelt_struct
+{
+  struct deq_struct data;
+  CMK_TYPEDEF_UINT8 key; /**< Priority in bitvector order; int priorities occupy the upper 32 bits */
+  int islong; /**< 64-bit priority: sorts after an int priority with the same key */
+  struct intprioqelt_struct *ht_next; /**< Pointer to next bucket in hash table. */
+  struct intprioqelt_struct **ht_handle; /**< Pointer to pointer that points to me (!) */
+  struct prio_struct pri; /**< The same priority as a bitvector; must be last */
+}
+*_intprioqelt;
+
+/**
+   A priority queue specialized for 32 and 64 bit priorities (the int
+   and long queueing strategies, and bitvectors of exactly those
+   lengths), implemented as a heap of intprioqelt_struct buckets
+   compared by integer key, with a hash table from key to bucket.
+*/
+typedef struct intprioq_struct
+{
+  int heapsize;
+  int heapnext;
+  _intprioqelt *heap; /**< An array of intprioqelt's */
+  _intprioqelt *hashtab;
+  int hash_bits; /**< The hash table has 2^hash_bits slots */
+  int hash_entry_size;
+  _intprioqelt last; /**< Bucket of the last enqueue, reused by runs of equal priorities */
+}
+*_intprioq;
+
 /*#ifndef FASTQ*/
 /**
-   A set of 3 queues: a positive priority prioq_struct, a negative
-   priority prioq_struct, and a zero priority deq_struct.
+   A set of 4 queues: a positive priority prioq_struct, a negative
+   priority prioq_struct, a zero priority deq_struct, and an
+   intprioq_struct holding both positive and negative priorities of
+   exactly 32 or 64 bits.
    
    If the user modifies the queue, NULL entries may be present, and
    hence NULL values will be returned by CqsDequeue().
@@ -132,6 +168,7 @@ typedef struct Queue_struct
   struct deq_struct zeroprio; /**< A double ended queue for zero priority messages */
   struct prioq_struct negprioq; /**< A priority queue for negative priority messages */
   struct prioq_struct posprioq; /**< A priority queue for negative priority messages */
+  struct intprioq_struct intprioq; /**< A priority queue for int and long priority messages */
 #endif
 }
 *Queue;
@@ -149,8 +186,8 @@ typedef struct Queue1_struct
 */
 
 /**
-    Initialize a Queue and its three internal queues (for positive,
-    negative, and zero priorities)
+    Initialize a Queue and its internal queues (for positive,
+    negative, and zero priorities, and for int and long priorities)
 */
 Queue CqsCreate(void);
 
@@ -19,6 +19,18 @@
 // take advantage of nonuniform filling of buffers
 #define CMK_TRAM_OVERALLOCATION_FACTOR 4
 
+// with adaptive buffering, each aggregation buffer is sent once it holds
+// as many items as its destination is expected to receive within
+// CMK_TRAM_BUFFER_AGE_LIMIT_MS, estimated from the fill rate of previously
+// sent buffers; thresholds never drop below 1/CMK_TRAM_MIN_BUFFER_FRACTION
+// of the allocated buffer size
+#define CMK_TRAM_BUFFER_AGE_LIMIT_MS 1.0
+#define CMK_TRAM_MIN_BUFFER_FRACTION 16
+
+// when idle flushing is enabled, buffers holding items for at least this
+// long are sent out whenever the PE runs out of work
+#define CMK_TRAM_IDLE_FLUSH_DELAY_MS 0.1
+
 // #define CMK_TRAM_CACHE_ARRAY_METADATA // only works for 1D array clients
 // #define CMK_TRAM_VERBOSE_OUTPUT
 
@@ -65,6 +77,44 @@ struct TramBroadcastInstance<CkArrayIndex>{
   static CkArrayIndex& value(int);
 };
 
+// per-instance aggregation counters, useful for tuning buffer sizes and
+// flush periods; all fields are summed by MeshStreamer::reportStats
+struct MeshStreamerStats {
+  CmiUInt8 itemsAggregated;  // items copied into aggregation buffers
+  CmiUInt8 messagesSent;
+  CmiUInt8 itemsSent;
+  CmiUInt8 slotsSent;        // allocated buffer capacity of sent messages
+  CmiUInt8 thresholdSends;   // buffer reached its send threshold
+  CmiUInt8 capacitySends;    // total buffering limit reached
+  CmiUInt8 flushSends;       // periodic, explicit and termination flushes
+  CmiUInt8 idleSends;        // idle-triggered partial flushes
+
+  MeshStreamerStats() { reset(); }
+
+  void reset() { memset(this, 0, sizeof(MeshStreamerStats)); }
+
+  // fraction of the allocated buffer space that was filled on send
+  double meanFill() const {
+    return slotsSent == 0 ? 0.0 : (double) itemsSent / slotsSent;
+  }
+
+  double meanItemsPerMessage() const {
+    return messagesSent == 0 ? 0.0 : (double) itemsSent / messagesSent;
+  }
+
+  void print(const char *name = "TRAM") const {
+    CkPrintf("%s: %llu items aggregated, %llu messages sent, "
+             "%.2f items/message, mean fill %.1f%% (sends: %llu threshold, "
+             "%llu capacity, %llu flush, %llu idle)\n", name,
+             (unsigned long long) itemsAggregated,
+             (unsigned long long) messagesSent, meanItemsPerMessage(),
+             100.0 * meanFill(), (unsigned long long) thresholdSends,
+             (unsigned long long) capacitySends,
+             (unsigned long long) flushSends, (unsigned long long) idleSends);
+  }
+};
+PUPbytes(MeshStreamerStats)
+
 template<class dtype>
 class MeshStreamerMessage : public CMessage_MeshStreamerMessage<dtype> {
 
@@ -124,6 +174,23 @@ private:
   int numLocalContributors_;
   CompletionStatus myCompletionStatus_;
 
+  // adaptive buffer sizing: send thresholds and allocation times
+  //  of the aggregation buffers, indexed like dataBuffers_
+  bool useAdaptiveBuffering_;
+  int minBufferSize_;
+  double bufferAgeLimit_;
+  std::vector<std::vector<int> > bufferThresholds_;
+  std::vector<std::vector<double> > bufferStartTimes_;
+
+  // idle-triggered flushing, active along with periodic flushing
+  bool useIdleFlushing_;
+  double idleFlushDelay_;
+  double nextIdleCheckTime_;
+  int beginIdleCallbackId_;
+  int stillIdleCallbackId_;
+
+  MeshStreamerStats stats_;
+
   virtual void localDeliver(const dtype& dataItem) { CkAbort("Called what should be a pure virtual base method"); }
   virtual void localBroadcast(const dtype& dataItem) { CkAbort("Called what should be a pure virtual base method"); }
 
@@ -132,6 +199,12 @@ private:
   void sendLargestBuffer();
   void flushToIntermediateDestinations();
   void flushDimension(int dimension, bool sendMsgCounts = false);
+  void flushBuffer(int dimension, int bufferIndex, bool sendMsgCounts);
+  void shrinkBuffer(MeshStreamerMessage<dtype> *buffer);
+  void recordSend(MeshStreamerMessage<dtype> *buffer, int dimension,
+                  int bufferIndex, bool adapt);
+  void registerIdleFlushFunctions();
+  void cancelIdleFlushFunctions();
 
 protected:
 
@@ -159,8 +232,12 @@ protected:
 
 public:
 
-  MeshStreamer() {}
-  MeshStreamer(CkMigrateMessage *) {}
+  MeshStreamer() : beginIdleCallbackId_(-1), stillIdleCallbackId_(-1) {}
+  MeshStreamer(CkMigrateMessage *)
+    : beginIdleCallbackId_(-1), stillIdleCallbackId_(-1) {}
+  ~MeshStreamer() {
+    cancelIdleFlushFunctions();
+  }
   MeshStreamer(int maxNumDataItemsBuffered, int numDimensions,
                int *dimensionSizes, int bufferSize,
                bool yieldFlag = 0, double progressPeriodInMs = -1.0);
@@ -180,6 +257,9 @@ public:
 
     isPeriodicFlushEnabled_ = true;
     registerPeriodicProgressFunction();
+    if (useIdleFlushing_) {
+      registerIdleFlushFunctions();
+    }
   }
   void finish();
   void init(int numLocalContributors, CkCallback startCb, CkCallback endCb,
@@ -193,13 +273,48 @@ public:
 
   void syncInit();
 
+  // contribute the sum of the statistics over all PEs to cb as an
+  //  array of CmiUInt8 laid out like MeshStreamerStats
+  void reportStats(CkCallback cb) {
+    this->contribute(sizeof(MeshStreamerStats), &stats_,
+                     CkReduction::sum_ulong_long, cb);
+  }
+
   virtual void receiveAtDestination(MeshStreamerMessage<dtype> *msg) { CkAbort("Called what should be a pure virtual base method"); }
 
   // non entry
   void flushIfIdle();
+  void flushOldBuffers(double currentTime);
   inline bool isPeriodicFlushEnabled() {
     return isPeriodicFlushEnabled_;
   }
+
+  // adapt per-destination send thresholds to the observed fill rate so
+  //  that buffers are sent within bufferAgeLimitInMs of their first item
+  inline void enableAdaptiveBuffering(double bufferAgeLimitInMs =
+                                        CMK_TRAM_BUFFER_AGE_LIMIT_MS) {
+    useAdaptiveBuffering_ = true;
+    bufferAgeLimit_ = bufferAgeLimitInMs / 1000.0;
+  }
+  void disableAdaptiveBuffering();
+
+  // while periodic flushing is enabled, also send buffers at least
+  //  delayInMs old whenever this PE becomes idle
+  inline void enableIdleFlushing(double delayInMs =
+                                   CMK_TRAM_IDLE_FLUSH_DELAY_MS) {
+    useIdleFlushing_ = true;
+    idleFlushDelay_ = delayInMs / 1000.0;
+    if (isPeriodicFlushEnabled_) {
+      registerIdleFlushFunctions();
+    }
+  }
+  inline void disableIdleFlushing() {
+    useIdleFlushing_ = false;
+    cancelIdleFlushFunctions();
+  }
+
+  inline const MeshStreamerStats& getStats() const { return stats_; }
+  inline void resetStats() { stats_.reset(); }
   virtual void insertData(const dtype& dataItem, int destinationPe);
   virtual void broadcast(const dtype& dataItem);
 
@@ -259,6 +374,7 @@ public:
 #endif
       CkAssert(numDataItemsBuffered_ == 0);
       isPeriodicFlushEnabled_ = false;
+      cancelIdleFlushFunctions();
       if (!userCallback_.isInvalid()) {
         this->contribute(userCallback_);
         userCallback_ = CkCallback();
@@ -356,6 +472,21 @@ ctorHelper(int maxNumDataItemsBuffered, int numDimensions,
     }
   }
 
+  bufferThresholds_.resize(numDimensions_);
+  bufferStartTimes_.resize(numDimensions_);
+  for (int i = 0; i < numDimensions; i++) {
+    bufferThresholds_[i].assign(myRouter_.numBuffersPerDimension(i),
+                                bufferSize_);
+    bufferStartTimes_[i].assign(myRouter_.numBuffersPerDimension(i), 0.0);
+  }
+  minBufferSize_ = std::max(1, bufferSize_ / CMK_TRAM_MIN_BUFFER_FRACTION);
+  useAdaptiveBuffering_ = false;
+  bufferAgeLimit_ = CMK_TRAM_BUFFER_AGE_LIMIT_MS / 1000.0;
+  useIdleFlushing_ = false;
+  idleFlushDelay_ = CMK_TRAM_IDLE_FLUSH_DELAY_MS / 1000.0;
+  nextIdleCheckTime_ = 0.0;
+  beginIdleCallbackId_ = stillIdleCallbackId_ = -1;
+
   isPeriodicFlushEnabled_ = false;
   detectorLocalObj_ = NULL;
 
@@ -435,6 +566,7 @@ storeMessage(int destinationPe, const Route& destinationRoute,
     *(int *) CkPriorityPtr(messageBuffers[bufferIndex]) = prio_;
     CkSetQueueing(messageBuffers[bufferIndex], CK_QUEUEING_IFIFO);
     CkAssert(messageBuffers[bufferIndex] != NULL);
+    bufferStartTimes_[dimension][bufferIndex] = CkWallTimer();
   }
 
   MeshStreamerMessage<dtype> *destinationBuffer = messageBuffers[bufferIndex];
@@ -444,13 +576,23 @@ storeMessage(int destinationPe, const Route& destinationRoute,
     destinationBuffer->markDestination(numBuffered-1, destinationPe);
   }
   numDataItemsBuffered_++;
+  stats_.itemsAggregated++;
 
-  // send if buffer is full
-  if (numBuffered == bufferSize_) {
+  // send if buffer has reached its send threshold
+  if (numBuffered >= bufferThresholds_[dimension][bufferIndex]) {
 
+    shrinkBuffer(destinationBuffer);
+    recordSend(destinationBuffer, dimension, bufferIndex, true);
+    stats_.thresholdSends++;
+    // as in flushBuffer, messages to this PE are not counted for staged
+    //  completion; with adaptive thresholds, this buffer is sent often
+    bool toSelf = destinationRoute.destinationPe == myIndex_;
+    if (toSelf) {
+      destinationBuffer->finalMsgCount = -2;
+    }
     sendMeshStreamerMessage(destinationBuffer, dimension,
                             destinationRoute.destinationPe);
-    if (useStagedCompletion_) {
+    if (useStagedCompletion_ && !toSelf) {
       cntMsgSent_[dimension][bufferIndex]++;
     }
     messageBuffers[bufferIndex] = NULL;
@@ -664,6 +806,7 @@ template <class dtype, class RouterType>
 void MeshStreamer<dtype, RouterType>::finish() {
 
   isPeriodicFlushEnabled_ = false;
+  cancelIdleFlushFunctions();
 
   if (!userCallback_.isInvalid()) {
     this->contribute(userCallback_);
@@ -747,10 +890,10 @@ inline void MeshStreamer<dtype, RouterType>::sendLargestBuffer() {
       destinationBuffer = messageBuffers[flushIndex];
 
       // not sending the full buffer, shrink the message size
-      envelope *env = UsrToEnv(destinationBuffer);
-      env->shrinkUsersize((bufferSize_ - destinationBuffer->numDataItems)
-                        * sizeof(dtype));
+      shrinkBuffer(destinationBuffer);
       numDataItemsBuffered_ -= destinationBuffer->numDataItems;
+      recordSend(destinationBuffer, flushDimension, flushIndex, true);
+      stats_.capacitySends++;
 
       destinationIndex =
         myRouter_.nextPeAlongRoute(flushDimension, flushIndex);
@@ -790,42 +933,125 @@ flushDimension(int dimension, bool sendMsgCounts) {
 #endif
 
   for (int j = 0; j < messageBuffers.size(); j++) {
-
-    if (messageBuffers[j] == NULL && !sendMsgCounts) {
-      continue;
+    if (messageBuffers[j] != NULL || sendMsgCounts) {
+      flushBuffer(dimension, j, sendMsgCounts);
+      stats_.flushSends++;
     }
-    if(messageBuffers[j] == NULL && sendMsgCounts) {
-        messageBuffers[j] = new (0, 0, 8 * sizeof(int))
-          MeshStreamerMessage<dtype>(myRouter_.determineMsgType(dimension));
-        *(int *) CkPriorityPtr(messageBuffers[j]) = prio_;
-        CkSetQueueing(messageBuffers[j], CK_QUEUEING_IFIFO);
-    }
-    else {
-      // if not sending the full buffer, shrink the message size
-      envelope *env = UsrToEnv(messageBuffers[j]);
-      const UInt s = (bufferSize_ - messageBuffers[j]->numDataItems) * sizeof(dtype);
-      if (env->getUsersize() > s) {
-        env->shrinkUsersize(s);
+  }
+}
+
+template <class dtype, class RouterType>
+void MeshStreamer<dtype, RouterType>::
+flushBuffer(int dimension, int bufferIndex, bool sendMsgCounts) {
+
+  std::vector<MeshStreamerMessage<dtype> *>
+    &messageBuffers = dataBuffers_[dimension];
+
+  if (messageBuffers[bufferIndex] == NULL) {
+    messageBuffers[bufferIndex] = new (0, 0, 8 * sizeof(int))
+      MeshStreamerMessage<dtype>(myRouter_.determineMsgType(dimension));
+    *(int *) CkPriorityPtr(messageBuffers[bufferIndex]) = prio_;
+    CkSetQueueing(messageBuffers[bufferIndex], CK_QUEUEING_IFIFO);
+  }
+  else {
+    // if not sending the full buffer, shrink the message size
+    shrinkBuffer(messageBuffers[bufferIndex]);
+  }
+
+  MeshStreamerMessage<dtype> *destinationBuffer = messageBuffers[bufferIndex];
+  int destinationIndex = myRouter_.nextPeAlongRoute(dimension, bufferIndex);
+  numDataItemsBuffered_ -= destinationBuffer->numDataItems;
+  if (useStagedCompletion_) {
+    if (destinationIndex == myIndex_) {
+      destinationBuffer->finalMsgCount = -2;
+    } else {
+      cntMsgSent_[dimension][bufferIndex]++;
+      if (sendMsgCounts) {
+        destinationBuffer->finalMsgCount = cntMsgSent_[dimension][bufferIndex];
       }
     }
-    
-    MeshStreamerMessage<dtype> *destinationBuffer = messageBuffers[j];
-    int destinationIndex = myRouter_.nextPeAlongRoute(dimension, j);
-    numDataItemsBuffered_ -= destinationBuffer->numDataItems;
-    if (useStagedCompletion_) {
-      if (destinationIndex == myIndex_) {
-        destinationBuffer->finalMsgCount = -2;
-      } else {
-        cntMsgSent_[dimension][j]++;
-        if (sendMsgCounts) {
-          destinationBuffer->finalMsgCount = cntMsgSent_[dimension][j];
-        }
+    CkAssert(!sendMsgCounts || destinationBuffer->finalMsgCount != -1);
+  }
+  // final flushes are not representative of the fill rate
+  recordSend(destinationBuffer, dimension, bufferIndex, !sendMsgCounts);
+  sendMeshStreamerMessage(destinationBuffer, dimension, destinationIndex);
+  messageBuffers[bufferIndex] = NULL;
+}
+
+template <class dtype, class RouterType>
+inline void MeshStreamer<dtype, RouterType>::
+shrinkBuffer(MeshStreamerMessage<dtype> *buffer) {
+  envelope *env = UsrToEnv(buffer);
+  const UInt s = (bufferSize_ - buffer->numDataItems) * sizeof(dtype);
+  if (s > 0 && env->getUsersize() > s) {
+    env->shrinkUsersize(s);
+  }
+}
+
+template <class dtype, class RouterType>
+inline void MeshStreamer<dtype, RouterType>::
+recordSend(MeshStreamerMessage<dtype> *buffer, int dimension,
+           int bufferIndex, bool adapt) {
+
+  int numItems = buffer->numDataItems;
+  stats_.messagesSent++;
+  stats_.itemsSent += numItems;
+  // the empty messages of a final flush only carry counts; they allocate no
+  //  item slots and would pull the mean fill down
+  if (numItems > 0) {
+    stats_.slotsSent += bufferSize_;
+  }
+
+  if (adapt && useAdaptiveBuffering_ && numItems > 0) {
+    // estimate how many items arrive for this destination within the age
+    //  limit, and move the send threshold halfway towards the estimate
+    double age = CkWallTimer() - bufferStartTimes_[dimension][bufferIndex];
+    double expected = bufferSize_;
+    if (age * bufferSize_ > numItems * bufferAgeLimit_) {
+      expected = numItems * bufferAgeLimit_ / age;
+    }
+    int &threshold = bufferThresholds_[dimension][bufferIndex];
+    threshold = std::max(minBufferSize_,
+                         (int) (0.5 * (threshold + expected) + 0.5));
+  }
+}
+
+template <class dtype, class RouterType>
+void MeshStreamer<dtype, RouterType>::
+disableAdaptiveBuffering() {
+  useAdaptiveBuffering_ = false;
+  for (int i = 0; i < numDimensions_; i++) {
+    bufferThresholds_[i].assign(bufferThresholds_[i].size(), bufferSize_);
+  }
+}
+
+template <class dtype, class RouterType>
+void MeshStreamer<dtype, RouterType>::flushOldBuffers(double currentTime) {
+
+  // buffers are only checked once the oldest one may have become due
+  if (numDataItemsBuffered_ == 0 || currentTime < nextIdleCheckTime_) {
+    return;
+  }
+
+  double oldestStartTime = currentTime;
+  for (int i = 0; i < numDimensions_; i++) {
+    std::vector<MeshStreamerMessage<dtype> *> &messageBuffers = dataBuffers_[i];
+    for (int j = 0; j < messageBuffers.size(); j++) {
+      if (messageBuffers[j] == NULL) {
+        continue;
+      }
+      double startTime = bufferStartTimes_[i][j];
+      if (currentTime - startTime >= idleFlushDelay_) {
+        flushBuffer(i, j, false);
+        stats_.idleSends++;
+      }
+      else if (startTime < oldestStartTime) {
+        oldestStartTime = startTime;
       }
-      CkAssert(!sendMsgCounts || destinationBuffer->finalMsgCount != -1);
     }
-    sendMeshStreamerMessage(destinationBuffer, dimension, destinationIndex);
-    messageBuffers[j] = NULL;
   }
+  nextIdleCheckTime_ = oldestStartTime < currentTime ?
+    oldestStartTime + idleFlushDelay_ : 0.0;
 }
 
 template <class dtype, class RouterType>
@@ -864,6 +1090,39 @@ void MeshStreamer<dtype, RouterType>::registerPeriodicProgressFunction() {
                  progressPeriodInMs_);
 }
 
+template <class dtype, class RouterType>
+void idleFlushFunction(void *MeshStreamerObj, double time) {
+
+  MeshStreamer<dtype, RouterType> *properObj =
+    static_cast<MeshStreamer<dtype, RouterType>*>(MeshStreamerObj);
+
+  properObj->flushOldBuffers(time);
+}
+
+template <class dtype, class RouterType>
+void MeshStreamer<dtype, RouterType>::registerIdleFlushFunctions() {
+  if (beginIdleCallbackId_ >= 0) {
+    return;
+  }
+  nextIdleCheckTime_ = 0.0;
+  beginIdleCallbackId_ =
+    CcdCallOnConditionKeep(CcdPROCESSOR_BEGIN_IDLE,
+                           idleFlushFunction<dtype, RouterType>, (void *) this);
+  stillIdleCallbackId_ =
+    CcdCallOnConditionKeep(CcdPROCESSOR_STILL_IDLE,
+                           idleFlushFunction<dtype, RouterType>, (void *) this);
+}
+
+template <class dtype, class RouterType>
+void MeshStreamer<dtype, RouterType>::cancelIdleFlushFunctions() {
+  if (beginIdleCallbackId_ < 0) {
+    return;
+  }
+  CcdCancelCallOnConditionKeep(CcdPROCESSOR_BEGIN_IDLE, beginIdleCallbackId_);
+  CcdCancelCallOnConditionKeep(CcdPROCESSOR_STILL_IDLE, stillIdleCallbackId_);
+  beginIdleCallbackId_ = stillIdleCallbackId_ = -1;
+}
+
 template <class dtype, class RouterType>
 void MeshStreamer<dtype, RouterType>::pup(PUP::er &p) {
   // private members
@@ -892,6 +1151,22 @@ void MeshStreamer<dtype, RouterType>::pup(PUP::er &p) {
   p|numLocalContributors_;
   p|myCompletionStatus_;
 
+  p|useAdaptiveBuffering_;
+  p|minBufferSize_;
+  p|bufferAgeLimit_;
+  p|bufferThresholds_;
+  p|useIdleFlushing_;
+  p|idleFlushDelay_;
+  p|stats_;
+  if (p.isUnpacking()) {
+    // buffer ages are not meaningful across processes
+    bufferStartTimes_.resize(bufferThresholds_.size());
+    for (int i = 0; i < bufferThresholds_.size(); i++) {
+      bufferStartTimes_[i].assign(bufferThresholds_[i].size(), CkWallTimer());
+    }
+    nextIdleCheckTime_ = 0.0;
+  }
+
   // protected members
   p|myRouter_;
   p|numMembers_;
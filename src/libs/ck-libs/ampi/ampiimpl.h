@@ -136,6 +136,14 @@ extern int AMPI_RDMA_THRESHOLD;
 #define AMPI_ALLTOALL_LONG_MSG   32768
 #endif
 
+/* Broadcasts, and allreduces with a predefined op, whose type signature is up to
+ * this many bytes are done with point-to-point messages: combined within blocks
+ * of co-located ranks, then along a binomial tree or by recursive doubling among
+ * the blocks, rather than by a Charm++ array broadcast and reduction */
+#ifndef AMPI_SHORT_COLL_MSG
+#define AMPI_SHORT_COLL_MSG 2048
+#endif
+
 typedef void (*MPI_MigrateFn)(void);
 
 /*
@@ -1084,6 +1092,8 @@ extern int _mpi_nworlds;
 #define MPI_RMA_TAG         MPI_TAG_UB_VALUE+10
 #define MPI_EPOCH_START_TAG MPI_TAG_UB_VALUE+11
 #define MPI_EPOCH_END_TAG   MPI_TAG_UB_VALUE+12
+#define MPI_ALLREDUCE_TAG   MPI_TAG_UB_VALUE+13
+#define MPI_BCAST_TREE_TAG  MPI_TAG_UB_VALUE+14
 
 #define AMPI_COLL_SOURCE 0
 #define AMPI_COLL_COMM   MPI_COMM_WORLD
@@ -2476,6 +2486,21 @@ class ampi final : public CBase_ampi {
   // Store generalized request classes created by MPIX_Grequest_class_create
   vector<greq_class_desc> greq_classes;
 
+  // Short allreduces: while this rank leads its block of co-located ranks, the
+  // other ranks of the block on this PE leave their buffers here and wait until
+  // the leader has written the result into them. Only in use during a
+  // collective, so not pupped.
+  struct ShortCollEntry {
+    void *buf;
+    int count;
+    CkDDT_DataType *ddt;
+    ampi *rank;
+  };
+  vector<ShortCollEntry> shortCollEntries; // indexed by rank offset in the block
+  int shortCollArrived;  // entries left for the leader's next allreduce
+  int shortCollExpected; // entries the blocked leader waits for, or -1
+  bool shortCollDone;    // the leader has written this rank's result
+
  private:
   ampiCommStruct myComm;
   vector<int> tmpVec; // stores temp group info
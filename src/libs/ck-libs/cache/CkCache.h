@@ -2,9 +2,11 @@
 #define __CACHEMANAGER_H__
 
 #include <sys/types.h>
+#include <string.h>
 #include <vector>
 #include <map>
 #include <set>
+#include <algorithm>
 #include "charm++.h"
 #include "envelope.h"
 
@@ -43,18 +45,25 @@ class CkCacheStatistics {
   CmiUInt8 totalDataRequested;
   CmiUInt8 maxData;
   int index;
+  CmiUInt8 hits;
+  CmiUInt8 misses;
+  CmiUInt8 evictions;
+  CmiUInt8 evictedBytes;
 
   CkCacheStatistics() : dataArrived(0), dataTotalArrived(0),
     dataMisses(0), dataLocal(0), dataError(0),
-    totalDataRequested(0), maxData(0), index(-1) { }
+    totalDataRequested(0), maxData(0), index(-1),
+    hits(0), misses(0), evictions(0), evictedBytes(0) { }
   
  public:
   CkCacheStatistics(CmiUInt8 pa, CmiUInt8 pta, CmiUInt8 pm,
           CmiUInt8 pl, CmiUInt8 pe, CmiUInt8 tpr,
-          CmiUInt8 mp, int i) :
+          CmiUInt8 mp, int i, CmiUInt8 h = 0, CmiUInt8 m = 0,
+          CmiUInt8 ev = 0, CmiUInt8 evb = 0) :
     dataArrived(pa), dataTotalArrived(pta), dataMisses(pm),
     dataLocal(pl), dataError(pe), totalDataRequested(tpr),
-    maxData(mp), index(i) { }
+    maxData(mp), index(i), hits(h), misses(m),
+    evictions(ev), evictedBytes(evb) { }
 
   void printTo(CkOStream &os) {
     os << "  Cache: " << dataTotalArrived << " data arrived (corresponding to ";
@@ -65,6 +74,8 @@ class CkCacheStatistics {
     os << "  Cache: " << dataMisses << " misses during computation" << endl;
     os << "  Cache: Maximum of " << maxData << " data stored at a time in processor " << index << endl;
     os << "  Cache: local Chares made " << totalDataRequested << " requests" << endl;
+    os << "  Cache: " << hits << " hits, " << misses << " misses, ";
+    os << evictions << " evictions (" << evictedBytes << " bytes)" << endl;
   }
   
   static CkReduction::reducerType sum;
@@ -80,6 +91,10 @@ class CkCacheStatistics {
       ret.dataMisses += data->dataMisses;
       ret.dataLocal += data->dataLocal;
       ret.totalDataRequested += data->totalDataRequested;
+      ret.hits += data->hits;
+      ret.misses += data->misses;
+      ret.evictions += data->evictions;
+      ret.evictedBytes += data->evictedBytes;
       if (data->maxData > ret.maxData) {
         ret.maxData = data->maxData;
         ret.index = data->index;
@@ -150,6 +165,11 @@ public:
   bool requestSent;
   bool replyRecvd;
   bool writtenBack;
+  /// Set on every use, cleared by the eviction sweep (CLOCK second chance)
+  bool referenced;
+  /// Bytes of data counted against the cache budget; 0 for data that
+  /// was not received into the cache (e.g. returned by a local chare)
+  int storedBytes;
 #if COSMO_STATS > 1
   /// total number of requests to this cache entry
   int totalRequests;
@@ -161,6 +181,8 @@ public:
     replyRecvd = false;
     requestSent = false;
     writtenBack = false;
+    referenced = true;
+    storedBytes = 0;
     data = NULL;
     this->key = key;
     this->home = home;
@@ -183,6 +205,137 @@ public:
   }
 };
 
+/// Fold a cache key (a plain integer of 8 or 16 bytes) into a 64 bit hash
+template<class CkCacheKey>
+inline CmiUInt8 CkCacheKeyHash(const CkCacheKey &key) {
+  CmiUInt8 h = 0;
+  const char *p = (const char *)&key;
+  for (size_t i = 0; i < sizeof(CkCacheKey); i += sizeof(CmiUInt8)) {
+    CmiUInt8 w = 0;
+    memcpy(&w, p + i, std::min(sizeof(CmiUInt8), sizeof(CkCacheKey) - i));
+    h = (h ^ w) * 0x9E3779B97F4A7C15ULL;
+  }
+  return h;
+}
+
+/** Open-addressing (linear probing) hash table from cache keys to
+    values, with a std::map-like interface: find/end, operator[], erase,
+    and iteration over (key, value) pairs in slot order. Erasing shifts
+    later entries of the probe sequence back, so it never leaves
+    tombstones; it invalidates iterators other than the erased one. */
+template<class CkCacheKey, class Value>
+class CkCacheHashTable {
+ public:
+  typedef std::pair<CkCacheKey, Value> value_type;
+
+  class iterator {
+    CkCacheHashTable *t;
+    size_t i;
+    friend class CkCacheHashTable;
+    void skip() { while (i < t->slots.size() && !t->used[i]) ++i; }
+   public:
+    iterator() : t(NULL), i(0) { }
+    iterator(CkCacheHashTable *t_, size_t i_) : t(t_), i(i_) { skip(); }
+    value_type &operator*() const { return t->slots[i]; }
+    value_type *operator->() const { return &t->slots[i]; }
+    iterator &operator++() { ++i; skip(); return *this; }
+    iterator operator++(int) { iterator r(*this); ++*this; return r; }
+    bool operator==(const iterator &o) const { return i == o.i; }
+    bool operator!=(const iterator &o) const { return i != o.i; }
+  };
+
+ private:
+  std::vector<value_type> slots;
+  std::vector<char> used;
+  size_t count;
+  int bits;
+
+  size_t home(const CkCacheKey &key) const {
+    return (size_t)(CkCacheKeyHash(key) >> (64 - bits));
+  }
+
+  void grow() {
+    std::vector<value_type> oslots;
+    std::vector<char> oused;
+    oslots.swap(slots);
+    oused.swap(used);
+    bits++;
+    slots.resize((size_t)1 << bits);
+    used.assign((size_t)1 << bits, 0);
+    for (size_t i = 0; i < oslots.size(); ++i) {
+      if (!oused[i]) continue;
+      size_t j = home(oslots[i].first);
+      while (used[j]) j = (j + 1) & (slots.size() - 1);
+      slots[j] = oslots[i];
+      used[j] = 1;
+    }
+  }
+
+ public:
+  CkCacheHashTable() : count(0), bits(4) {
+    slots.resize((size_t)1 << bits);
+    used.assign((size_t)1 << bits, 0);
+  }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, slots.size()); }
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  iterator find(const CkCacheKey &key) {
+    size_t mask = slots.size() - 1;
+    for (size_t i = home(key); used[i]; i = (i + 1) & mask)
+      if (slots[i].first == key) return iterator(this, i);
+    return end();
+  }
+
+  Value &operator[](const CkCacheKey &key) {
+    // Keep the load factor at or below 1/2
+    if (2 * (count + 1) > slots.size()) grow();
+    size_t mask = slots.size() - 1;
+    size_t i = home(key);
+    for (; used[i]; i = (i + 1) & mask)
+      if (slots[i].first == key) return slots[i].second;
+    slots[i] = value_type(key, Value());
+    used[i] = 1;
+    count++;
+    return slots[i].second;
+  }
+
+  void erase(iterator it) { eraseSlot(it.i); }
+
+  void clear() {
+    if (count == 0) return;
+    used.assign(slots.size(), 0);
+    count = 0;
+  }
+
+  /// Slot-level access, used by the eviction sweep
+  size_t slotCount() const { return slots.size(); }
+  bool occupied(size_t i) const { return used[i]; }
+  value_type &slot(size_t i) { return slots[i]; }
+
+  /// Remove the entry in slot i; a later entry may be moved into slot i
+  void eraseSlot(size_t i) {
+    size_t mask = slots.size() - 1;
+    size_t j = i;
+    used[i] = 0;
+    count--;
+    while (true) {
+      j = (j + 1) & mask;
+      if (!used[j]) break;
+      size_t h = home(slots[j].first);
+      // Move slots[j] back if its home does not lie in (i, j]
+      if ((j > i && (h <= i || h > j)) || (j < i && (h <= i && h > j))) {
+        slots[i] = slots[j];
+        used[i] = 1;
+        used[j] = 0;
+        i = j;
+      }
+    }
+  }
+};
+
 class CkCacheArrayCounter : public CkLocIterator {
 public:
   int count;
@@ -252,8 +405,12 @@ class CkCacheManager : public CBase_CkCacheManager<CkCacheKey> {
   /// update the chunk division based on these values
   CmiUInt8 *chunkWeight;
 
-  /// Maximum number of allowed data stored
+  /// Maximum number of bytes of received data stored at a time, from the
+  /// size given at construction. It is only enforced if eviction was turned
+  /// on with setEviction(); entries are then evicted in CLOCK order.
+  /// 0 means no limit.
   CmiUInt8 maxSize;
+  bool evictionEnabled;
   
   /// number of acknowledgements awaited before deleting the chunk
   int *chunkAck;
@@ -261,12 +418,24 @@ class CkCacheManager : public CBase_CkCacheManager<CkCacheKey> {
   int *chunkAckWB;
 
   /// hash table containing all the entries currently in the cache
-  std::map<CkCacheKey,CkCacheEntry<CkCacheKey>*> *cacheTable;
-  int storedData;
+  typedef CkCacheHashTable<CkCacheKey, CkCacheEntry<CkCacheKey>*> CacheTable;
+  CacheTable *cacheTable;
+  CmiUInt8 storedData;
 
   /// list of all the outstanding requests. The second field is the chunk for
   /// which this request is outstanding
-  std::map<CkCacheKey,int> outStandingRequests;
+  CkCacheHashTable<CkCacheKey, int> outStandingRequests;
+
+  /// Position of the eviction sweep: a chunk and a slot in its table
+  int clockChunk;
+  size_t clockSlot;
+
+  /// Requests served from the cache, requests that had to fetch or wait,
+  /// and entries (and their bytes) evicted to stay within maxSize
+  CmiUInt8 cacheHits;
+  CmiUInt8 cacheMisses;
+  CmiUInt8 cacheEvictions;
+  CmiUInt8 cacheEvictedBytes;
     
   /***********************************************************************
    * Methods definitions
@@ -284,6 +453,13 @@ class CkCacheManager : public CBase_CkCacheManager<CkCacheKey> {
   void init();
  public:
 
+  /// Evict unused entries once the stored data exceeds maxSize. Off by
+  /// default, so data stays cached until its chunk is finished. Evicted data
+  /// is freed, so with eviction on, chares must not keep pointers to cached
+  /// data across entry methods that can fill the cache. This only affects
+  /// the local branch, so it has to be called on every PE.
+  void setEviction(bool enable) { evictionEnabled = enable; }
+
   void * requestData(CkCacheKey what, CkArrayIndex &toWhom, int chunk, CkCacheEntryType<CkCacheKey> *type, CkCacheRequestorData<CkCacheKey> &req);
   void * requestDataNoFetch(CkCacheKey key, int chunk);
   CkCacheEntry<CkCacheKey> * requestCacheEntryNoFetch(CkCacheKey key, int chunk);
@@ -305,7 +481,13 @@ class CkCacheManager : public CBase_CkCacheManager<CkCacheKey> {
 
   /** Collect the statistics for the latest iteration */
   void collectStatistics(CkCallback cb);
-  std::map<CkCacheKey,CkCacheEntry<CkCacheKey>*> *getCache();
+  CacheTable *getCache();
+
+ private:
+  /// Account for newly received data, and evict if over budget
+  void storeData(CkCacheEntry<CkCacheKey> *e);
+  /// Evict unused entries until the stored data fits in maxSize
+  void evict();
 
 };
 
@@ -316,6 +498,7 @@ class CkCacheManager : public CBase_CkCacheManager<CkCacheKey> {
     init();
     numLocMgr = 1;
     numLocMgrWB = 0;
+    locMgrWB = NULL;
     locMgr = new CkGroupID[1];
     locMgr[0] = gid;
     maxSize = (CmiUInt8)size * 1024 * 1024;
@@ -326,6 +509,7 @@ class CkCacheManager : public CBase_CkCacheManager<CkCacheKey> {
     init();
     numLocMgr = n;
     numLocMgrWB = 0;
+    locMgrWB = NULL;
     locMgr = new CkGroupID[n];
     for (int i=0; i<n; ++i) locMgr[i] = gid[i];
     maxSize = (CmiUInt8)size * 1024 * 1024;
@@ -349,11 +533,18 @@ class CkCacheManager : public CBase_CkCacheManager<CkCacheKey> {
     numLocMgr = 0;
     locMgr = NULL;
     maxSize = 0;
+    evictionEnabled = false;
     syncdChares = 0;
     cacheTable = NULL;
     chunkAck = NULL;
     chunkWeight = NULL;
     storedData = 0;
+    clockChunk = 0;
+    clockSlot = 0;
+    cacheHits = 0;
+    cacheMisses = 0;
+    cacheEvictions = 0;
+    cacheEvictedBytes = 0;
 #if COSMO_STATS > 0
     dataArrived = 0;
     dataTotalArrived = 0;
@@ -372,12 +563,13 @@ class CkCacheManager : public CBase_CkCacheManager<CkCacheKey> {
     if (p.isUnpacking()) locMgrWB = new CkGroupID[numLocMgrWB];
     PUP::PUParray(p,locMgrWB,numLocMgrWB);
     p | maxSize;
+    p | evictionEnabled;
   }
 
   template<class CkCacheKey>
   void * CkCacheManager<CkCacheKey>::requestData(CkCacheKey what, CkArrayIndex &_toWhom, int chunk, CkCacheEntryType<CkCacheKey> *type, CkCacheRequestorData<CkCacheKey> &req)
   {
-    typename std::map<CkCacheKey, CkCacheEntry<CkCacheKey>* >::iterator  p;
+    typename CacheTable::iterator p;
     CkArrayIndex toWhom(_toWhom);
     CkAssert(chunkAck[chunk] > 0);
     p = cacheTable[chunk].find(what);
@@ -393,9 +585,12 @@ class CkCacheManager : public CBase_CkCacheManager<CkCacheKey> {
 #if COSMO_STATS > 1
       e->totalRequests++;
 #endif
+      e->referenced = true;
       if (e->data != NULL) {
+        cacheHits++;
         return e->data;
       }
+      cacheMisses++;
       if (!e->requestSent) {// || _nocache) {
         e->requestSent = true;
         if ((e->data = type->request(toWhom, what)) != NULL) {
@@ -404,6 +599,7 @@ class CkCacheManager : public CBase_CkCacheManager<CkCacheKey> {
         }
       }
     } else {
+      cacheMisses++;
       e = new CkCacheEntry<CkCacheKey>(what, toWhom, type);
 #if COSMO_STATS > 1
       e->totalRequests++;
@@ -426,8 +622,9 @@ class CkCacheManager : public CBase_CkCacheManager<CkCacheKey> {
 
   template<class CkCacheKey>
   void * CkCacheManager<CkCacheKey>::requestDataNoFetch(CkCacheKey key, int chunk) {
-    typename std::map<CkCacheKey,CkCacheEntry<CkCacheKey> *>::iterator p = cacheTable[chunk].find(key);
+    typename CacheTable::iterator p = cacheTable[chunk].find(key);
     if (p != cacheTable[chunk].end()) {
+      p->second->referenced = true;
       return p->second->data;
     }
     return NULL;
@@ -435,29 +632,84 @@ class CkCacheManager : public CBase_CkCacheManager<CkCacheKey> {
   
   template<class CkCacheKey>
   CkCacheEntry<CkCacheKey> * CkCacheManager<CkCacheKey>::requestCacheEntryNoFetch(CkCacheKey key, int chunk) {
-    typename std::map<CkCacheKey,CkCacheEntry<CkCacheKey> *>::iterator p = cacheTable[chunk].find(key);
+    typename CacheTable::iterator p = cacheTable[chunk].find(key);
     if (p != cacheTable[chunk].end()) {
+      p->second->referenced = true;
       return p->second;
     }
     return NULL;
   }
   
   template<class CkCacheKey>
-  std::map<CkCacheKey,CkCacheEntry<CkCacheKey>*> *CkCacheManager<CkCacheKey>::getCache(){
+  typename CkCacheManager<CkCacheKey>::CacheTable *CkCacheManager<CkCacheKey>::getCache(){
     return cacheTable;
   }
 
+  template<class CkCacheKey>
+  void CkCacheManager<CkCacheKey>::storeData(CkCacheEntry<CkCacheKey> *e) {
+    e->referenced = true;
+    e->storedBytes = e->type->size(e->data);
+    storedData += e->storedBytes;
+#if COSMO_STATS > 0
+    if (maxData < storedData) maxData = storedData;
+#endif
+    if (evictionEnabled && maxSize > 0 && storedData > maxSize) evict();
+  }
+
+  template<class CkCacheKey>
+  void CkCacheManager<CkCacheKey>::evict() {
+    // Entries are candidates once their data has arrived, nobody is waiting
+    // on them, and (for arrays with writeback) they have been written back,
+    // so that evicting never sends partial updates home. Data returned by
+    // local chares is not counted against the budget and is left alone.
+    // Each candidate gets a second chance if it was used since the sweep
+    // last passed it.
+    if (numChunks == 0) return;
+    size_t budget = 0;
+    for (int c = 0; c < numChunks; ++c) budget += 2 * cacheTable[c].slotCount();
+
+    while (storedData > maxSize && budget-- > 0) {
+      CacheTable &table = cacheTable[clockChunk];
+      if (clockSlot >= table.slotCount()) {
+        clockSlot = 0;
+        clockChunk = (clockChunk + 1) % numChunks;
+        continue;
+      }
+      if (!table.occupied(clockSlot)) {
+        clockSlot++;
+        continue;
+      }
+      CkCacheEntry<CkCacheKey> *e = table.slot(clockSlot).second;
+      if (e->storedBytes == 0 || !e->requestorVec.empty()
+          || (numLocMgrWB > 0 && !e->writtenBack)) {
+        clockSlot++;
+        continue;
+      }
+      if (e->referenced) {
+        e->referenced = false;
+        clockSlot++;
+        continue;
+      }
+      storedData -= e->storedBytes;
+      cacheEvictions++;
+      cacheEvictedBytes += e->storedBytes;
+      delete e;
+      // A later entry may have moved into this slot; look at it next
+      table.eraseSlot(clockSlot);
+    }
+  }
+
 template <class CkCacheKey> 
 inline void CkCacheManager<CkCacheKey>::recvData(CkCacheKey key, void *data, CkCacheFillMsg<CkCacheKey> *msg) {
 
-    typename std::map<CkCacheKey,int>::iterator pchunk = outStandingRequests.find(key);
+    typename CkCacheHashTable<CkCacheKey,int>::iterator pchunk = outStandingRequests.find(key);
     CkAssert(pchunk != outStandingRequests.end());
     int chunk = pchunk->second;
     CkAssert(chunk >= 0 && chunk < numChunks);
     CkAssert(chunkAck[chunk] > 0);
     outStandingRequests.erase(pchunk);
 
-    typename std::map<CkCacheKey,CkCacheEntry<CkCacheKey>*>::iterator p;
+    typename CacheTable::iterator p;
     p = cacheTable[chunk].find(key);
     CkAssert(p != cacheTable[chunk].end());
     CkCacheEntry<CkCacheKey> *e = p->second;
@@ -467,13 +719,13 @@ inline void CkCacheManager<CkCacheKey>::recvData(CkCacheKey key, void *data, CkC
     else {
       e->data = data; 
     }
-    storedData += e->type->size(e->data);
     
     typename std::vector<CkCacheRequestorData<CkCacheKey> >::iterator caller;
     for (caller = e->requestorVec.begin(); caller != e->requestorVec.end(); caller++) {
       caller->deliver(key, e->data, chunk);
     }
     e->requestorVec.clear();
+    storeData(e);
 
 }
 
@@ -485,25 +737,25 @@ inline void CkCacheManager<CkCacheKey>::recvData(CkCacheKey key, void *data, CkC
   
   template<class CkCacheKey>
   void CkCacheManager<CkCacheKey>::recvData(CkCacheKey key, CkArrayIndex &from, CkCacheEntryType<CkCacheKey> *type, int chunk, void *data) {
-    typename std::map<CkCacheKey,CkCacheEntry<CkCacheKey>*>::iterator p = cacheTable[chunk].find(key);
+    typename CacheTable::iterator p = cacheTable[chunk].find(key);
     CkCacheEntry<CkCacheKey> *e;
     if (p == cacheTable[chunk].end()) {
       e = new CkCacheEntry<CkCacheKey>(key, from, type);
       cacheTable[chunk][key] = e;
     } else {
       e = p->second;
-      storedData -= e->type->size(e->data);
+      storedData -= e->storedBytes;
       e->type->writeback(e->home, e->key, e->data);
     }
     e->replyRecvd = true;
     e->data = data;
-    storedData += e->type->size(data);
     
     typename std::vector<CkCacheRequestorData<CkCacheKey> >::iterator caller;
     for (caller = e->requestorVec.begin(); caller != e->requestorVec.end(); caller++) {
       caller->deliver(key, e->data, chunk);
     }
     e->requestorVec.clear();
+    storeData(e);
   }
 
   template<class CkCacheKey>
@@ -536,6 +788,10 @@ inline void CkCacheManager<CkCacheKey>::recvData(CkCacheKey key, void *data, CkC
       totalDataRequested = 0;
       maxData = 0;
 #endif
+      cacheHits = 0;
+      cacheMisses = 0;
+      cacheEvictions = 0;
+      cacheEvictedBytes = 0;
 
       for (int chunk=0; chunk<numChunks; ++chunk) {
         CkAssert(cacheTable[chunk].empty());
@@ -544,6 +800,8 @@ inline void CkCacheManager<CkCacheKey>::recvData(CkCacheKey key, void *data, CkC
       }
       CkAssert(outStandingRequests.empty());
       storedData = 0;
+      clockChunk = 0;
+      clockSlot = 0;
 
       if (numChunks != _numChunks) {
         if(numChunks != 0) {
@@ -554,7 +812,7 @@ inline void CkCacheManager<CkCacheKey>::recvData(CkCacheKey key, void *data, CkC
         }
 	  
         numChunks = _numChunks;
-        cacheTable = new std::map<CkCacheKey,CkCacheEntry<CkCacheKey>*>[numChunks];
+        cacheTable = new CacheTable[numChunks];
         chunkAck = new int[numChunks];
         chunkAckWB = new int[numChunks];
         chunkWeight = new CmiUInt8[numChunks];
@@ -583,7 +841,7 @@ inline void CkCacheManager<CkCacheKey>::recvData(CkCacheKey key, void *data, CkC
       // we can safely write back the chunk to the senders
       // at this point no more changes to the data can be made until next fetch
 
-      typename std::map<CkCacheKey,CkCacheEntry<CkCacheKey>*>::iterator iter;
+      typename CacheTable::iterator iter;
       for (iter = cacheTable[chunk].begin(); iter != cacheTable[chunk].end(); iter++) {
         CkCacheEntry<CkCacheKey> *e = iter->second;
         e->writeback();
@@ -608,10 +866,10 @@ inline void CkCacheManager<CkCacheKey>::recvData(CkCacheKey key, void *data, CkC
       if (maxData < storedData) maxData = storedData;
 #endif
 
-      typename std::map<CkCacheKey,CkCacheEntry<CkCacheKey>*>::iterator iter;
+      typename CacheTable::iterator iter;
       for (iter = cacheTable[chunk].begin(); iter != cacheTable[chunk].end(); iter++) {
         CkCacheEntry<CkCacheKey> *e = iter->second;
-        storedData -= e->type->size(e->data);
+        storedData -= e->storedBytes;
         
         // TODO: Store communication pattern here
 
@@ -630,11 +888,13 @@ inline void CkCacheManager<CkCacheKey>::recvData(CkCacheKey key, void *data, CkC
 #if COSMO_STATS > 0
     CkCacheStatistics cs(dataArrived, dataTotalArrived,
         dataMisses, dataLocal, dataError, totalDataRequested,
-        maxData, CkMyPe());
-    contribute(sizeof(CkCacheStatistics), &cs, CkCacheStatistics::sum, cb);
+        maxData, CkMyPe(), cacheHits, cacheMisses,
+        cacheEvictions, cacheEvictedBytes);
 #else
-    CkAbort("Invalid call, only valid if COSMO_STATS is defined");
+    CkCacheStatistics cs(0, 0, 0, 0, 0, 0, 0, CkMyPe(), cacheHits,
+        cacheMisses, cacheEvictions, cacheEvictedBytes);
 #endif
+    this->contribute(sizeof(CkCacheStatistics), &cs, CkCacheStatistics::sum, cb);
   }
 
 #define CK_TEMPLATES_ONLY
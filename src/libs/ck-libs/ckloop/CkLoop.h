@@ -9,6 +9,10 @@
 #include <atomic>
 #define USE_TREE_BROADCAST_THRESHOLD 8
 #define TREE_BCAST_BRANCH (4)
+/* levels of the combining tree for user reductions: enough for 2^32 helpers */
+#define REDUCE_TREE_LEVELS (32)
+/* adaptive chunking never hands out chunks shorter than this (seconds) */
+#define ADAPTIVE_MIN_CHUNK_TIME (2e-6)
 
 /* 1. Using converse-level msg, then the msg is always of highest priority.
  * And the notification msg comes from the singlehelper where the loop parallelization
@@ -37,6 +41,10 @@ private:
     std::atomic<int> curChunkIdx;
     int numChunks;
     int chunkSize;
+    CkLoop_chunking chunking;
+    int numWorkers;   // helpers that may join; divides the remaining work
+    int finishTarget; // chunks (STATIC) or iterations (GUIDED/ADAPTIVE)
+    std::atomic<int> nextIndex; // first unclaimed iteration for GUIDED/ADAPTIVE
     REDUCTION_TYPE type; // only used in hybrid mode
     HelperFn fnPtr;
     int lowerIndex;
@@ -47,6 +55,26 @@ private:
     void **redBufs;
     char *bufSpace;
 
+    // Per-worker accumulators, used by user reductions and by built-in
+    // reductions with GUIDED/ADAPTIVE chunking. Each slot holds the
+    // accumulator followed by a scratch buffer for the next chunk.
+    ReducerFn redFn;
+    void *redParam;
+    int redSize;
+    int slotStride;
+    int maxSlots;
+    int slotBytes;
+    char *slotSpace;
+    std::atomic<int> numSlots;
+    // pending[l] is a partial result waiting for a partner at tree level l
+    std::atomic<char *> pending[REDUCE_TREE_LEVELS];
+
+    // observed chunk times for ADAPTIVE chunking
+    std::atomic<int> statChunks;
+    std::atomic<long long> statIters;
+    std::atomic<double> statTime;   // sum of chunk times
+    std::atomic<double> statTimeSq; // sum of time^2/iterations over chunks
+
     std::atomic<int> finishFlag;
 
     //a tag to indicate whether the task for this new loop has been inited
@@ -59,8 +87,10 @@ private:
     std::atomic<int> numDynamicChunksFired{0};
 
 public:
-    CurLoopInfo(int maxChunks):curChunkIdx(-1),numChunks(0),fnPtr(NULL), lowerIndex(-1), upperIndex(0),
-            paramNum(0), param(NULL), redBufs(NULL), bufSpace(NULL), finishFlag(0), inited(0) {
+    CurLoopInfo(int maxChunks):curChunkIdx(-1),numChunks(0),chunking(CKLOOP_STATIC_CHUNKS),numWorkers(1),
+            finishTarget(0),nextIndex(0),fnPtr(NULL), lowerIndex(-1), upperIndex(0),
+            paramNum(0), param(NULL), redBufs(NULL), bufSpace(NULL), redFn(NULL), redParam(NULL),
+            redSize(0), slotStride(0), maxSlots(0), slotBytes(0), slotSpace(NULL), numSlots(0), finishFlag(0), inited(0) {
         redBufs = new void *[maxChunks];
         bufSpace = new char[maxChunks * CMI_CACHE_LINE_SIZE];
         for (int i=0; i<maxChunks; i++) redBufs[i] = (void *)(bufSpace+i*CMI_CACHE_LINE_SIZE);
@@ -69,9 +99,11 @@ public:
     ~CurLoopInfo() {
         delete [] redBufs;
         delete [] bufSpace;
+        if (slotSpace) CmiFreeAligned(slotSpace);
     }
 
-    void set(int nc, HelperFn f, int lIdx, int uIdx, int numParams, void *p) {        /*
+    void set(int nc, HelperFn f, int lIdx, int uIdx, int numParams, void *p,
+             CkLoop_chunking policy=CKLOOP_STATIC_CHUNKS, int workers=1) {        /*
       * The locking is to handle a rare data-racing case here. The current loop is
       * about to finish (just before setting inited to 0; A helper (say B)
       * just enters the stealWork and passes the inited check. The helper
@@ -88,6 +120,14 @@ public:
         paramNum = numParams;
         param = p;
         curChunkIdx = -1;
+        chunking = policy;
+        numWorkers = workers;
+        finishTarget = (policy == CKLOOP_STATIC_CHUNKS) ? nc : uIdx-lIdx+1;
+        nextIndex = lIdx;
+        statChunks = 0;
+        statIters = 0;
+        statTime = 0.0;
+        statTimeSq = 0.0;
         finishFlag = 0;
         //needs to be set last
         inited = 1;
@@ -98,6 +138,24 @@ public:
       type = p;
     }
 
+    // Has to be called before set(), while no helper can run this loop.
+    void setReducer(ReducerFn fn, int size, void *p, int workers) {
+      redFn = fn;
+      redParam = p;
+      redSize = size;
+      if (fn == NULL) return;
+      int stride = 2*CmiRoundUpToPow2(size, CMI_CACHE_LINE_SIZE);
+      if (stride*workers > slotBytes) {
+        if (slotSpace) CmiFreeAligned(slotSpace);
+        slotBytes = stride*workers;
+        slotSpace = (char *)CmiMallocAligned(slotBytes, CMI_CACHE_LINE_SIZE);
+      }
+      slotStride = stride;
+      maxSlots = workers;
+      numSlots = 0;
+      for (int i=0; i<REDUCE_TREE_LEVELS; i++) pending[i] = NULL;
+    }
+
     void setStaticFraction(float _staticFraction) {
       staticFraction = _staticFraction;
     }
@@ -144,7 +202,7 @@ public:
 
     void waitLoopDone(int sync) {
         //while(!__sync_bool_compare_and_swap(&finishFlag, numChunks, 0));
-        if (sync) while (finishFlag.load(std::memory_order_relaxed)!=numChunks);
+        if (sync) while (finishFlag.load(std::memory_order_relaxed)!=finishTarget);
         std::atomic_thread_fence(std::memory_order_acquire);
        //finishFlag = 0;
         CmiLock(loop_info_inited_lock);
@@ -177,7 +235,7 @@ public:
     }
 
     int isFree() {
-      int fin = finishFlag.load(std::memory_order_acquire) == numChunks;
+      int fin = finishFlag.load(std::memory_order_acquire) == finishTarget;
       return fin;
     }
 
@@ -185,6 +243,13 @@ public:
         return redBufs;
     }
 
+    void getChunkBounds(int chunkId, int &first, int &last);
+    bool claimChunk(int &first, int &last, int &chunkId);
+    int dynamicChunkSize(int remaining);
+    void recordChunkTime(int iters, double t);
+    void combinePartial(char *acc);
+    void collectResult(void *result);
+    void stealWorkSlots();
     void stealWork();
     void doWorkForMyPe();
 };
@@ -236,6 +301,11 @@ private:
     int numHelpers; //in pthread mode, the counter includes itself
     FuncSingleHelper **helperPtr; /* ptrs to the FuncSingleHelpers it manages */
     CkLoop_sched schedPolicy;
+    CkLoop_chunking chunkPolicy;
+
+    CurLoopInfo *startLoop(HelperFn func, int paramNum, void *param, int numChunks,
+                           int lowerRange, int upperRange, CkLoop_chunking chunking,
+                           ReducerFn redFn, int redSize, void *redParam, int &sync);
 
 public:
     FuncCkLoop(int mode_, int numThreads_);
@@ -294,6 +364,16 @@ public:
                CallerFn cfunc=NULL, /* the caller PE will call this function before starting to work on the chunks */
                int cparamNum=0, void* cparam=NULL /* the input parameters to the above function */
                );
+    void setChunkPolicy(CkLoop_chunking chunkPolicy) {
+      this->chunkPolicy = chunkPolicy;
+    }
+    CkLoop_chunking getChunkPolicy() {
+      return chunkPolicy;
+    }
+    void parallelizeFuncReduce(HelperFn func, int paramNum, void * param,
+                               int numChunks, int lowerRange, int upperRange,
+                               void *redResult, int redSize, ReducerFn redFn, void *redParam,
+                               CallerFn cfunc=NULL, int cparamNum=0, void* cparam=NULL);
     void destroyHelpers();
     void reduce(void **redBufs, void *redBuf, REDUCTION_TYPE type, int numChunks);
     void pup(PUP::er &p);
@@ -2,11 +2,15 @@
 #define _CKLOOPAPI_H
 
 #include "CkLoop.decl.h"
+#include <type_traits>
 
 /* "result" is the buffer for reduction result on a single simple-type variable */
 typedef void (*HelperFn)(int first,int last, void *result, int paramNum, void *param);
 /* Function that will be executed by the caller PE before ckloop is done */
 typedef void (*CallerFn)(int paramNum, void *param);
+/* User-defined reduction: combine the partial result "in" into "inout"; both
+ * point to "size" bytes of POD data. Must be associative and commutative. */
+typedef void (*ReducerFn)(void *inout, const void *in, int size, void *redParam);
 
 typedef enum REDUCTION_TYPE {
     CKLOOP_NONE=0,
@@ -18,6 +22,14 @@ typedef enum REDUCTION_TYPE {
 
 typedef enum CkLoop_sched { CKLOOP_NODE_QUEUE=0, CKLOOP_TREE, CKLOOP_LIST} CkLoop_sched;
 
+/* How [lowerRange, upperRange] is cut into chunks:
+ * STATIC: numChunks equal chunks (default);
+ * GUIDED: each chunk is the remaining iterations divided by the number of
+ *   helpers, so chunks shrink as the loop drains;
+ * ADAPTIVE: chunk sizes follow the factoring rule using the mean and
+ *   variance of the per-iteration time observed on the chunks done so far. */
+typedef enum CkLoop_chunking { CKLOOP_STATIC_CHUNKS=0, CKLOOP_GUIDED_CHUNKS, CKLOOP_ADAPTIVE_CHUNKS } CkLoop_chunking;
+
 class CProxy_FuncCkLoop;
 /*
  * "numThreads" argument is intended to be used in non-SMP mode to specify
@@ -52,8 +64,42 @@ extern void CkLoop_ParallelizeHybrid(
     int cparamNum=0, void *cparam=NULL /* the input parameters to the above function */
 );
 
+/* Like CkLoop_Parallelize, but reduces an arbitrary POD buffer of "redSize"
+ * bytes with "redFn". Each call of "func" stores its partial result in the
+ * "result" buffer it is given; partial results are combined on the helper
+ * that computed them and then in a tree across helpers. Always synchronous. */
+extern void CkLoop_ParallelizeReduce(
+    HelperFn func, /* the function that finishes a partial work on another thread */
+    int paramNum, void * param, /* the input parameters for the above func */
+    int numChunks, /* number of chunks to be partitioned (STATIC chunking) */
+    int lowerRange, int upperRange, /* the loop-like parallelization happens in [lowerRange, upperRange] */
+    void *redResult, int redSize, /* the reduction result buffer and its size in bytes */
+    ReducerFn redFn, void *redParam=NULL, /* the combine function and its parameter */
+    CallerFn cfunc=NULL, /* caller PE will call this function before ckloop is done and before starting to work on its chunks */
+    int cparamNum=0, void *cparam=NULL /* the input parameters to the above function */
+);
+
+template <class T, class Op>
+static void CkLoop_FunctorReducer(void *inout, const void *in, int size, void *op) {
+  (*static_cast<Op *>(op))(*static_cast<T *>(inout), *static_cast<const T *>(in));
+}
+
+/* Reduce into a POD value of type T with a functor "op(T &inout, const T &in)",
+ * e.g. a struct holding a minimum and its index, or an array of sums. */
+template <class T, class Op>
+inline void CkLoop_ParallelizeReduce(HelperFn func, int paramNum, void *param,
+    int numChunks, int lowerRange, int upperRange, T *redResult, Op &op,
+    CallerFn cfunc=NULL, int cparamNum=0, void *cparam=NULL) {
+  static_assert(std::is_trivially_copyable<T>::value, "CkLoop reductions need a POD result type");
+  CkLoop_ParallelizeReduce(func, paramNum, param, numChunks, lowerRange, upperRange,
+      (void *)redResult, sizeof(T), CkLoop_FunctorReducer<T, Op>, (void *)&op,
+      cfunc, cparamNum, cparam);
+}
 
 extern void CkLoop_SetSchedPolicy(CkLoop_sched schedPolicy);
 
+/* Chunking used by the CkLoop_Parallelize* calls on this node */
+extern void CkLoop_SetChunkPolicy(CkLoop_chunking chunkPolicy);
+
 extern void CkLoop_DestroyHelpers();
 #endif
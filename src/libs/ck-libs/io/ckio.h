@@ -12,13 +12,15 @@ namespace Ck { namespace IO {
   /// Users should not set anything in them.
   struct Options {
     Options()
-      : peStripe(0), writeStripe(0), activePEs(-1), basePE(-1), skipPEs(-1)
+      : peStripe(0), writeStripe(0), readStripe(0), activePEs(-1), basePE(-1), skipPEs(-1)
       { }
 
     /// How much contiguous data (in bytes) should be assigned to each active PE
     size_t peStripe;
     /// How much contiguous data (in bytes) should a PE gather before writing it out
     size_t writeStripe;
+    /// How much contiguous data (in bytes) should a PE read in one call
+    size_t readStripe;
     /// How many PEs should participate in this activity
     int activePEs;
     /// Which PE should be the first to participate in this activity
@@ -29,6 +31,7 @@ namespace Ck { namespace IO {
     void pup(PUP::er &p) {
       p|peStripe;
       p|writeStripe;
+      p|readStripe;
       p|activePEs;
       p|basePE;
       p|skipPEs;
@@ -67,6 +70,25 @@ namespace Ck { namespace IO {
   /// offset is relative to the file as a whole, not to the session's offset.
   void write(Session session, const char *data, size_t bytes, size_t offset);
 
+  /// Prepare to read data from @arg file, in the window defined by the
+  /// @arg offset and length in @arg bytes. The window is loaded by a set of
+  /// reader chares, each reading one aligned stripe of it, placed round-robin
+  /// on the active PEs given by activePEs, basePE and skipPEs. When every
+  /// stripe has been read, a SessionReadyMsg will be sent to the @arg ready
+  /// callback.
+  void startReadSession(File file, size_t bytes, size_t offset, CkCallback ready);
+
+  /// Read @arg bytes at @arg offset from the window of a read session into
+  /// @arg data. The offset is relative to the file as a whole. The reader
+  /// chares put their stripes directly into @arg data, which must remain
+  /// valid until a ReadCompleteMsg has been sent to the @arg after callback.
+  void read(Session session, size_t bytes, size_t offset, char *data,
+            CkCallback after);
+
+  /// Release the reader chares of a read session. All reads on the session
+  /// must have already completed.
+  void closeReadSession(Session session, CkCallback closed);
+
   /// Close a previously-opened file. All sessions on that file must have
   /// already signalled that they are complete.
   void close(File file, CkCallback closed);
@@ -78,6 +100,8 @@ namespace Ck { namespace IO {
     friend void startSession(File file, size_t bytes, size_t offset, CkCallback ready,
                              const char *commitData, size_t commitBytes, size_t commitOffset,
                              CkCallback complete);
+    friend void startReadSession(File file, size_t bytes, size_t offset,
+                                 CkCallback ready);
     friend void close(File file, CkCallback closed);
     friend class FileReadyMsg;
 
@@ -100,6 +124,7 @@ namespace Ck { namespace IO {
     size_t bytes, offset;
     CkArrayID sessionID;
     friend class Ck::IO::impl::Manager;
+    friend void closeReadSession(Session session, CkCallback closed);
   public:
     Session(int file_, size_t bytes_, size_t offset_,
             CkArrayID sessionID_)
@@ -120,5 +145,13 @@ namespace Ck { namespace IO {
     SessionReadyMsg(Session session_) : session(session_) { }
   };
 
+  class ReadCompleteMsg : public CMessage_ReadCompleteMsg {
+  public:
+    size_t offset, bytes;
+    char *data;
+    ReadCompleteMsg(size_t offset_, size_t bytes_, char *data_)
+      : offset(offset_), bytes(bytes_), data(data_) { }
+  };
+
 }}
 #endif
@@ -0,0 +1,189 @@
+/*
+  An open-addressing hash map with the subset of the std::unordered_map
+  interface used by the runtime's lookup tables.
+
+  Entries live in one flat array, probed linearly from the slot picked by a
+  (scrambled) hash of the key, next to a byte array recording which slots are
+  in use.  A lookup therefore touches one or two cache lines instead of
+  following a bucket pointer to a separately allocated node, and each entry
+  costs its key and value plus one byte, instead of a heap node with its own
+  header and next pointer.  Erasing shifts the following entries of the probe
+  run back, so there are no tombstones and lookups never slow down with age.
+
+  Unlike std::unordered_map, inserting may move existing entries, and erasing
+  may move later entries into the erased slot, so both invalidate iterators
+  and references into the map.  Key and Value must be default constructible.
+*/
+#ifndef __CK_FLAT_HASH_MAP_H
+#define __CK_FLAT_HASH_MAP_H
+
+#include <stddef.h>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <class Key, class Value, class Hash = std::hash<Key>,
+          class KeyEqual = std::equal_to<Key> >
+class CkFlatHashMap {
+public:
+  typedef Key key_type;
+  typedef Value mapped_type;
+  typedef std::pair<Key, Value> value_type;
+  typedef size_t size_type;
+
+private:
+  std::vector<value_type> slots;
+  std::vector<unsigned char> used;
+  size_t mask;      // slots.size()-1, or 0 when nothing is allocated yet
+  size_t nentries;
+  Hash hasher;
+  KeyEqual equal;
+
+  // Spread the hash over the high bits: many of the runtime's keys (object
+  // IDs, std::hash of ints) are small consecutive integers.
+  inline size_t home(const Key &k) const {
+    unsigned long long h = (unsigned long long)hasher(k) * 0x9E3779B97F4A7C15ULL;
+    return (size_t)(h ^ (h >> 32)) & mask;
+  }
+
+  size_t findSlot(const Key &k) const {
+    if (nentries == 0) return slots.size();
+    for (size_t i = home(k); used[i]; i = (i + 1) & mask)
+      if (equal(slots[i].first, k)) return i;
+    return slots.size();
+  }
+
+  void rehash(size_t n) {
+    std::vector<value_type> oldSlots(n);
+    std::vector<unsigned char> oldUsed(n, 0);
+    oldSlots.swap(slots);
+    oldUsed.swap(used);
+    mask = n - 1;
+    for (size_t i = 0; i < oldSlots.size(); i++) {
+      if (!oldUsed[i]) continue;
+      size_t j = home(oldSlots[i].first);
+      while (used[j]) j = (j + 1) & mask;
+      used[j] = 1;
+      slots[j].first = std::move(oldSlots[i].first);
+      slots[j].second = std::move(oldSlots[i].second);
+    }
+  }
+
+  // Empty slot i, moving later entries of its probe run back into the hole
+  void eraseSlot(size_t i) {
+    size_t j = i;
+    while (true) {
+      j = (j + 1) & mask;
+      if (!used[j]) break;
+      size_t h = home(slots[j].first);
+      // Move j into the hole unless its home lies cyclically in (i, j]
+      if ((i <= j) ? (i < h && h <= j) : (i < h || h <= j)) continue;
+      slots[i].first = std::move(slots[j].first);
+      slots[i].second = std::move(slots[j].second);
+      i = j;
+    }
+    used[i] = 0;
+    slots[i] = value_type();
+    nentries--;
+  }
+
+public:
+  template <class MapPtr, class Ref>
+  class iter_base {
+    friend class CkFlatHashMap;
+    template <class, class> friend class iter_base;
+    MapPtr m;
+    size_t i;
+    void skip() { while (i < m->slots.size() && !m->used[i]) i++; }
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef typename CkFlatHashMap::value_type value_type;
+    typedef ptrdiff_t difference_type;
+    typedef typename std::remove_reference<Ref>::type *pointer;
+    typedef Ref reference;
+
+    iter_base() : m(NULL), i(0) {}
+    iter_base(MapPtr m_, size_t i_) : m(m_), i(i_) { skip(); }
+    // iterator to const_iterator
+    template <class M, class R>
+    iter_base(const iter_base<M, R> &o) : m(o.m), i(o.i) {}
+    Ref operator*() const { return m->slots[i]; }
+    pointer operator->() const { return &m->slots[i]; }
+    iter_base &operator++() { i++; skip(); return *this; }
+    iter_base operator++(int) { iter_base old = *this; ++*this; return old; }
+    template <class M, class R>
+    bool operator==(const iter_base<M, R> &o) const { return i == o.i; }
+    template <class M, class R>
+    bool operator!=(const iter_base<M, R> &o) const { return i != o.i; }
+  };
+  typedef iter_base<CkFlatHashMap *, value_type &> iterator;
+  typedef iter_base<const CkFlatHashMap *, const value_type &> const_iterator;
+
+  CkFlatHashMap() : mask(0), nentries(0) {}
+
+  size_t size() const { return nentries; }
+  bool empty() const { return nentries == 0; }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, slots.size()); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, slots.size()); }
+
+  iterator find(const Key &k) { return iterator(this, findSlot(k)); }
+  const_iterator find(const Key &k) const { return const_iterator(this, findSlot(k)); }
+  size_t count(const Key &k) const { return findSlot(k) != slots.size(); }
+
+  Value &operator[](const Key &k) {
+    size_t i = findSlot(k);
+    if (i != slots.size()) return slots[i].second;
+    // Keep the load factor at or below 3/4
+    if (4 * (nentries + 1) > 3 * slots.size())
+      rehash(slots.empty() ? 16 : 2 * slots.size());
+    for (i = home(k); used[i]; i = (i + 1) & mask) {}
+    used[i] = 1;
+    slots[i].first = k;
+    nentries++;
+    return slots[i].second;
+  }
+
+  std::pair<iterator, bool> insert(const value_type &v) {
+    size_t i = findSlot(v.first);
+    if (i != slots.size()) return std::make_pair(iterator(this, i), false);
+    (*this)[v.first] = v.second;
+    return std::make_pair(find(v.first), true);
+  }
+
+  void erase(iterator it) { eraseSlot(it.i); }
+  void erase(const_iterator it) { eraseSlot(it.i); }
+  size_t erase(const Key &k) {
+    size_t i = findSlot(k);
+    if (i == slots.size()) return 0;
+    eraseSlot(i);
+    return 1;
+  }
+
+  void clear() {
+    slots.clear();
+    used.clear();
+    mask = 0;
+    nentries = 0;
+  }
+
+  /// Make room for n entries without rehashing
+  void reserve(size_t n) {
+    size_t s = 16;
+    while (3 * s < 4 * n) s *= 2;
+    if (s > slots.size()) rehash(s);
+  }
+
+  void swap(CkFlatHashMap &o) {
+    slots.swap(o.slots);
+    used.swap(o.used);
+    std::swap(mask, o.mask);
+    std::swap(nentries, o.nentries);
+  }
+};
+
+#endif
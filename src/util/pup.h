@@ -406,8 +406,11 @@ class sizer : public er {
   size_t size(void) const {return nBytes;}
 };
 
+template <class T> class fixed_size;
+
 template <class T>
 inline size_t size(T &t) {
+	if (fixed_size<T>::value) return fixed_size<T>::bytes; //No traversal needed
 	PUP::sizer p; p|t; return p.size();
 }
 
@@ -462,6 +465,28 @@ inline void toMemBuf(T &t,void *buf, size_t len) {
 		"This means your pup routine doesn't match during sizing and packing");
 }
 
+//For packing in a single pass, without sizing first: starts in a small
+// inline buffer, and moves to a heap buffer that doubles as it fills up.
+// Copy the result out with get_orig_pointer() and size().
+class toGrowableMem : public mem {
+  enum {inlineSize=256};
+  size_t capacity; //Bytes available at origBuf
+  myByte inlineBuf[inlineSize];
+  void grow(size_t n);
+ protected:
+  //Generic bottleneck: pack n items of size itemSize from p.
+  virtual void bytes(void *p,size_t n,size_t itemSize,dataType t);
+
+  //Seek blocks store offsets, since the buffer may move
+  virtual void impl_startSeek(seekBlock &s);
+  virtual size_t impl_tell(seekBlock &s);
+  virtual void impl_seek(seekBlock &s,size_t off);
+ public:
+  //Reserve initialSize bytes up front if that is known to be needed
+  toGrowableMem(size_t initialSize=0);
+  ~toGrowableMem();
+};
+
 //For unpacking from a memory buffer
 class fromMem : public mem {
  protected:
@@ -949,6 +974,40 @@ namespace PUP {
 #endif
 	};
 
+	/**
+	  Traits class: the number of bytes T packs to, when that is
+	  known at compile time.  This is true of raw-byte types and
+	  fixed-size arrays of them, which can then be sized without
+	  running a PUP::sizer over them.  Use this like:
+	     if (PUP::fixed_size<someClass>::value)
+	        n=PUP::fixed_size<someClass>::bytes;
+	*/
+	template<class T> class fixed_size {
+#if defined(CK_CHECK_PUP) || defined(CK_DEFAULT_BITWISE_PUP)
+		/* every bytes() call is tagged, or as_bytes may not match operator| */
+		public: enum {value=0};
+		static constexpr size_t bytes=0;
+#else
+		public: enum {value=as_bytes<T>::value};
+		static constexpr size_t bytes=value?sizeof(T):0;
+#endif
+	};
+	template<class T> class fixed_size<const T> : public fixed_size<T> {};
+	template<class T,size_t N> class fixed_size<T[N]> {
+		public: enum {value=fixed_size<T>::value};
+		static constexpr size_t bytes=N*fixed_size<T>::bytes;
+	};
+
+	/// fixed_size for a list of types packed one after another.
+	template<class... Ts> class fixed_size_of {
+		public: enum {value=1};
+		static constexpr size_t bytes=0;
+	};
+	template<class T,class... Ts> class fixed_size_of<T,Ts...> {
+		public: enum {value=fixed_size<T>::value && fixed_size_of<Ts...>::value};
+		static constexpr size_t bytes=value?fixed_size<T>::bytes+fixed_size_of<Ts...>::bytes:0;
+	};
+
 
 #ifdef CK_DEFAULT_BITWISE_PUP   /* OLD compatability mode*/
 /// Default operator| and PUParray: copy as bytes.
@@ -414,6 +414,14 @@ using Requires = typename requires_impl<
     pup(p, a);
   }
 
+  // Pairs, tuples and std::arrays of fixed-size types are fixed-size too
+  template <class A, class B>
+  class fixed_size<std::pair<A, B> > : public fixed_size_of<A, B> {};
+  template <typename... Args>
+  class fixed_size<std::tuple<Args...> > : public fixed_size_of<Args...> {};
+  template <typename T, std::size_t N>
+  class fixed_size<std::array<T, N> > : public fixed_size<T[N]> {};
+
   template <typename T, Requires<std::is_enum<T>::value> = nullptr>
   inline void operator|(PUP::er& p, T& s) {
     pup_bytes(&p, static_cast<void*>(&s), sizeof(T));
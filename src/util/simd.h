@@ -11,6 +11,7 @@
 #else
   #include "math.h"
 #endif
+#include <string.h>
 
 #if defined(__VEC__)
   #include "altivec.h"
@@ -142,6 +143,16 @@ inline  __simdia_veci  __simdia_vdivi(const  __simdia_veci a, const  __simdia_ve
 inline  __simdia_vecf  __simdia_vdivf(const  __simdia_vecf a, const  __simdia_vecf b) {  __simdia_vecf r; r.v0 = a.v0 / b.v0; r.v1 = a.v1 / b.v1; r.v2 = a.v2 / b.v2; r.v3 = a.v3 / b.v3; return r; }
 inline __simdia_veclf __simdia_vdivlf(const __simdia_veclf a, const __simdia_veclf b) { __simdia_veclf r; r.v0 = a.v0 / b.v0; r.v1 = a.v1 / b.v1;                                         return r; }
 
+/***** Minimum *****/
+inline  __simdia_veci  __simdia_vmini(const  __simdia_veci a, const  __simdia_veci b) {  __simdia_veci r; r.v0 = (a.v0 < b.v0) ? a.v0 : b.v0; r.v1 = (a.v1 < b.v1) ? a.v1 : b.v1; r.v2 = (a.v2 < b.v2) ? a.v2 : b.v2; r.v3 = (a.v3 < b.v3) ? a.v3 : b.v3; return r; }
+inline  __simdia_vecf  __simdia_vminf(const  __simdia_vecf a, const  __simdia_vecf b) {  __simdia_vecf r; r.v0 = (a.v0 < b.v0) ? a.v0 : b.v0; r.v1 = (a.v1 < b.v1) ? a.v1 : b.v1; r.v2 = (a.v2 < b.v2) ? a.v2 : b.v2; r.v3 = (a.v3 < b.v3) ? a.v3 : b.v3; return r; }
+inline __simdia_veclf __simdia_vminlf(const __simdia_veclf a, const __simdia_veclf b) { __simdia_veclf r; r.v0 = (a.v0 < b.v0) ? a.v0 : b.v0; r.v1 = (a.v1 < b.v1) ? a.v1 : b.v1;                                                                     return r; }
+
+/***** Maximum *****/
+inline  __simdia_veci  __simdia_vmaxi(const  __simdia_veci a, const  __simdia_veci b) {  __simdia_veci r; r.v0 = (a.v0 > b.v0) ? a.v0 : b.v0; r.v1 = (a.v1 > b.v1) ? a.v1 : b.v1; r.v2 = (a.v2 > b.v2) ? a.v2 : b.v2; r.v3 = (a.v3 > b.v3) ? a.v3 : b.v3; return r; }
+inline  __simdia_vecf  __simdia_vmaxf(const  __simdia_vecf a, const  __simdia_vecf b) {  __simdia_vecf r; r.v0 = (a.v0 > b.v0) ? a.v0 : b.v0; r.v1 = (a.v1 > b.v1) ? a.v1 : b.v1; r.v2 = (a.v2 > b.v2) ? a.v2 : b.v2; r.v3 = (a.v3 > b.v3) ? a.v3 : b.v3; return r; }
+inline __simdia_veclf __simdia_vmaxlf(const __simdia_veclf a, const __simdia_veclf b) { __simdia_veclf r; r.v0 = (a.v0 > b.v0) ? a.v0 : b.v0; r.v1 = (a.v1 > b.v1) ? a.v1 : b.v1;                                                                     return r; }
+
 /***** Fused Multiply Add *****/
 inline  __simdia_veci  __simdia_vmaddi(const  __simdia_veci a, const  __simdia_veci b, const  __simdia_veci c) {  __simdia_veci r; r.v0 = a.v0 * b.v0 + c.v0; r.v1 = a.v1 * b.v1 + c.v1; r.v2 = a.v2 * b.v2 + c.v2; r.v3 = a.v3 * b.v3 + c.v3; return r; }
 inline  __simdia_vecf  __simdia_vmaddf(const  __simdia_vecf a, const  __simdia_vecf b, const  __simdia_vecf c) {  __simdia_vecf r; r.v0 = a.v0 * b.v0 + c.v0; r.v1 = a.v1 * b.v1 + c.v1; r.v2 = a.v2 * b.v2 + c.v2; r.v3 = a.v3 * b.v3 + c.v3; return r; }
@@ -410,6 +421,16 @@ inline __simdia_veci __simdia_vcmplelf(const  __simdia_vecf a, const  __simdia_v
   #define   simdia_vdivf(a, b)  (_mm_div_ps((a), (b)))
   #define  simdia_vdivlf(a, b)  (_mm_div_pd((a), (b)))
 
+  /***** Minimum *****/
+  inline simdia_veci simdia_vmini(const simdia_veci a, const simdia_veci b) { simdia_veci m = _mm_cmplt_epi32(a, b); return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+  #define   simdia_vminf(a, b)  (_mm_min_ps((a), (b)))
+  #define  simdia_vminlf(a, b)  (_mm_min_pd((a), (b)))
+
+  /***** Maximum *****/
+  inline simdia_veci simdia_vmaxi(const simdia_veci a, const simdia_veci b) { simdia_veci m = _mm_cmpgt_epi32(a, b); return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+  #define   simdia_vmaxf(a, b)  (_mm_max_ps((a), (b)))
+  #define  simdia_vmaxlf(a, b)  (_mm_max_pd((a), (b)))
+
   /***** Fused Multiply Add *****/
   #define  simdia_vmaddf(a, b, c)  ( vaddf( vmulf((a), (b)), (c)))
   #define simdia_vmaddlf(a, b, c)  (vaddlf(vmullf((a), (b)), (c)))
@@ -561,6 +582,16 @@ inline __simdia_veci __simdia_vcmplelf(const  __simdia_vecf a, const  __simdia_v
   #define simdia_vdivf(a, b)  (spu_mul((a), spu_re(b)))
   inline simdia_veclf simdia_vdivlf(const simdia_veclf a, const simdia_veclf b) { simdia_veclf r = { 0.0, 0.0 }; spu_insert((spu_extract(a, 0) / spu_extract(b, 0)), r, 0); spu_insert((spu_extract(a, 1) / spu_extract(b, 1)), r, 1); return r; }
 
+  /***** Minimum *****/
+  #define   simdia_vmini(a, b)  (spu_sel((b), (a), spu_cmpgt((b), (a))))
+  #define   simdia_vminf(a, b)  (spu_sel((b), (a), spu_cmpgt((b), (a))))
+  #define  simdia_vminlf(a, b)  (spu_sel((b), (a), spu_cmpgt((b), (a))))
+
+  /***** Maximum *****/
+  #define   simdia_vmaxi(a, b)  (spu_sel((b), (a), spu_cmpgt((a), (b))))
+  #define   simdia_vmaxf(a, b)  (spu_sel((b), (a), spu_cmpgt((a), (b))))
+  #define  simdia_vmaxlf(a, b)  (spu_sel((b), (a), spu_cmpgt((a), (b))))
+
   /***** Fused Multiply Add *****/
   #define  simdia_vmaddf(a, b, c)  (spu_madd((a), (b), (c)))
   #define simdia_vmaddlf(a, b, c)  (spu_madd((a), (b), (c)))
@@ -795,6 +826,24 @@ inline __simdia_veci __simdia_vcmplelf(const  __simdia_vecf a, const  __simdia_v
     #define simdia_vdivlf __simdia_vdivlf
   #endif
 
+  /***** Minimum *****/
+  #define  simdia_vmini(a, b)  (vec_min((a), (b)))
+  #define  simdia_vminf(a, b)  (vec_min((a), (b)))
+  #ifdef _ARCH_PWR7 
+    #define  simdia_vminlf(a, b)  (vec_min((a), (b)))
+  #else
+    #define simdia_vminlf __simdia_vminlf
+  #endif
+
+  /***** Maximum *****/
+  #define  simdia_vmaxi(a, b)  (vec_max((a), (b)))
+  #define  simdia_vmaxf(a, b)  (vec_max((a), (b)))
+  #ifdef _ARCH_PWR7 
+    #define  simdia_vmaxlf(a, b)  (vec_max((a), (b)))
+  #else
+    #define simdia_vmaxlf __simdia_vmaxlf
+  #endif
+
   /***** Fused Multiply Add *****/
   #define simdia_vmaddf(a, b, c)  (vec_madd((a), (b), (c)))
   #ifdef _ARCH_PWR7 
@@ -1012,6 +1061,16 @@ inline __simdia_veci __simdia_vcmplelf(const  __simdia_vecf a, const  __simdia_v
   #define  simdia_vdivf   __simdia_vdivf
   #define simdia_vdivlf  __simdia_vdivlf
 
+  /***** Minimum *****/
+  #define  simdia_vmini   __simdia_vmini
+  #define  simdia_vminf   __simdia_vminf
+  #define simdia_vminlf  __simdia_vminlf
+
+  /***** Maximum *****/
+  #define  simdia_vmaxi   __simdia_vmaxi
+  #define  simdia_vmaxf   __simdia_vmaxf
+  #define simdia_vmaxlf  __simdia_vmaxlf
+
   /***** Fused Multiply Add *****/
   #define  simdia_vmaddf  __simdia_vmaddf
   #define simdia_vmaddlf __simdia_vmaddlf
@@ -1114,6 +1173,14 @@ inline __simdia_veci __simdia_vcmplelf(const  __simdia_vecf a, const  __simdia_v
 #define  simdia_vspreadf(a)  ( simdia_vsetf(a))
 #define simdia_vspreadlf(a)  (simdia_vsetlf(a))
 
+/***** Unaligned Load and Store *****/
+inline  simdia_veci  simdia_vloadi(const    int *p) {  simdia_veci r; memcpy(&r, p, sizeof(r)); return r; }
+inline  simdia_vecf  simdia_vloadf(const  float *p) {  simdia_vecf r; memcpy(&r, p, sizeof(r)); return r; }
+inline simdia_veclf simdia_vloadlf(const double *p) { simdia_veclf r; memcpy(&r, p, sizeof(r)); return r; }
+inline void  simdia_vstorei(   int *p, const  simdia_veci v) { memcpy(p, &v, sizeof(v)); }
+inline void  simdia_vstoref( float *p, const  simdia_vecf v) { memcpy(p, &v, sizeof(v)); }
+inline void simdia_vstorelf(double *p, const simdia_veclf v) { memcpy(p, &v, sizeof(v)); }
+
 #define  simdia_visfinitef(a) (isfinite(simdia_vextractf((a),0)) && isfinite(simdia_vextractf((a),1)) && isfinite(simdia_vextractf((a),2)) && isfinite(simdia_vextractf((a),3)))
 #define simdia_visfinitelf(a) (isfinite(simdia_vextractlf((a),0)) && isfinite(simdia_vextractlf((a),1)))
 
@@ -35,6 +35,7 @@ class Parameter {
   friend class ParamList;
   void pup(XStr& str);
   void pupArray(XStr& str);
+  void pupType(XStr& str);
   void pupRdma(XStr& str, bool genRdma);
   void copyPtr(XStr& str);
   void check();
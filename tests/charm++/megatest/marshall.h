@@ -2,6 +2,7 @@
 #define _MARSHALL_H
 
 #include "charm++.h"
+#include "pup_stl.h"
 typedef CkMsgQ<CkMarshallMsg> msgQ_t;
 
 #include "marshall.decl.h"
@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <converse.h>
+
+void Cpm_megacon_ack(CpmDestination);
+
+/* Every PE floods PE 0 at once, stressing concurrent pushes into a
+   single receive queue.  PE 0 checks that no message is lost,
+   duplicated, or corrupted along the way. */
+
+#define nFanin 2000
+
+typedef struct
+{
+  char core[CmiMsgHeaderSizeBytes];
+  int src;
+  int seq;
+  int check;
+} faninmsg;
+
+CpvDeclare(int, fanin_start_index);
+CpvDeclare(int, fanin_recv_index);
+CpvDeclare(int, fanin_received);
+CpvDeclare(int *, fanin_counts);
+CpvDeclare(CmiInt8 *, fanin_sums);
+
+void fanin_fail(void)
+{
+  CmiAbort("fanin: message lost, duplicated or corrupted.\n");
+}
+
+void fanin_start(void *msg)
+{
+  int i;
+  CmiFree(msg);
+  for (i=0; i<nFanin; i++) {
+    faninmsg *m = (faninmsg *)CmiAlloc(sizeof(faninmsg));
+    CmiSetHandler(m, CpvAccess(fanin_recv_index));
+    m->src = CmiMyPe();
+    m->seq = i;
+    m->check = ~(m->src ^ i);
+    CmiSyncSendAndFree(0, sizeof(faninmsg), m);
+  }
+}
+
+void fanin_recv(faninmsg *m)
+{
+  int pe;
+  if (m->src < 0 || m->src >= CmiNumPes() || m->check != ~(m->src ^ m->seq))
+    fanin_fail();
+  CpvAccess(fanin_counts)[m->src]++;
+  CpvAccess(fanin_sums)[m->src] += m->seq;
+  CmiFree(m);
+  if (++CpvAccess(fanin_received) < nFanin * CmiNumPes())
+    return;
+
+  for (pe=0; pe<CmiNumPes(); pe++) {
+    if (CpvAccess(fanin_counts)[pe] != nFanin ||
+        CpvAccess(fanin_sums)[pe] != (CmiInt8)nFanin * (nFanin - 1) / 2)
+      fanin_fail();
+  }
+  Cpm_megacon_ack(CpmSend(0));
+}
+
+void fanin_init(void)
+{
+  int pe;
+  char *msg = (char *)CmiAlloc(CmiMsgHeaderSizeBytes);
+  CpvAccess(fanin_received) = 0;
+  for (pe=0; pe<CmiNumPes(); pe++) {
+    CpvAccess(fanin_counts)[pe] = 0;
+    CpvAccess(fanin_sums)[pe] = 0;
+  }
+  CmiSetHandler(msg, CpvAccess(fanin_start_index));
+  CmiSyncBroadcastAllAndFree(CmiMsgHeaderSizeBytes, msg);
+}
+
+void fanin_moduleinit(void)
+{
+  CpvInitialize(int, fanin_start_index);
+  CpvInitialize(int, fanin_recv_index);
+  CpvInitialize(int, fanin_received);
+  CpvInitialize(int *, fanin_counts);
+  CpvInitialize(CmiInt8 *, fanin_sums);
+
+  CpvAccess(fanin_start_index) = CmiRegisterHandler((CmiHandler)fanin_start);
+  CpvAccess(fanin_recv_index) = CmiRegisterHandler((CmiHandler)fanin_recv);
+  CpvAccess(fanin_counts) = (int *)malloc(CmiNumPes() * sizeof(int));
+  CpvAccess(fanin_sums) = (CmiInt8 *)malloc(CmiNumPes() * sizeof(CmiInt8));
+}
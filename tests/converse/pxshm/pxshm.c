@@ -0,0 +1,129 @@
+/*
+ * Sends messages of sizes just below, at and above the largest message
+ * that pxshm passes through its shared memory rings (1 MB by default,
+ * CHARM_PXSHM_MESSAGE_MAX_SIZE). Larger messages are read by the receiver
+ * over CMA where it is available. Every PE sends each size to every other
+ * PE, and the receivers check the contents. On builds without pxshm, the
+ * messages simply go through the regular network layer.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <converse.h>
+
+#define SHM_MAX_SIZE (1024 * 1024)
+
+static const int msgSizes[] = {
+  256,
+  SHM_MAX_SIZE - 64,
+  SHM_MAX_SIZE,
+  SHM_MAX_SIZE + 64,
+  3 * SHM_MAX_SIZE + 8
+};
+#define NUM_SIZES ((int)(sizeof(msgSizes) / sizeof(msgSizes[0])))
+
+typedef struct {
+  char core[CmiMsgHeaderSizeBytes];
+  int src;
+  int size;
+} testMsgHeader;
+
+CpvDeclare(int, dataHandler);
+CpvDeclare(int, doneHandler);
+CpvDeclare(int, exitHandler);
+CpvDeclare(int, numReceived);
+CpvDeclare(int, numDone);
+
+static unsigned char pattern(int src, int size, int i)
+{
+  return (unsigned char)(src * 131 + size * 7 + i * 13);
+}
+
+static void exitHandlerFunc(void *msg)
+{
+  CmiFree(msg);
+  CsdExitScheduler();
+}
+
+static void doneHandlerFunc(void *msg)
+{
+  CmiFree(msg);
+  if (++CpvAccess(numDone) == CmiNumPes()) {
+    void *exitMsg = CmiAlloc(CmiMsgHeaderSizeBytes);
+    CmiPrintf("pxshm: all %d message sizes delivered intact between %d PEs\n",
+              NUM_SIZES, CmiNumPes());
+    CmiSetHandler(exitMsg, CpvAccess(exitHandler));
+    CmiSyncBroadcastAllAndFree(CmiMsgHeaderSizeBytes, exitMsg);
+  }
+}
+
+static void sendDone(void)
+{
+  void *msg = CmiAlloc(CmiMsgHeaderSizeBytes);
+  CmiSetHandler(msg, CpvAccess(doneHandler));
+  CmiSyncSendAndFree(0, CmiMsgHeaderSizeBytes, msg);
+}
+
+static void dataHandlerFunc(void *vmsg)
+{
+  testMsgHeader *hdr = (testMsgHeader *)vmsg;
+  unsigned char *data = (unsigned char *)vmsg;
+  int i;
+  for (i = sizeof(testMsgHeader); i < hdr->size; i++) {
+    if (data[i] != pattern(hdr->src, hdr->size, i)) {
+      CmiPrintf("[%d] message of %d bytes from PE %d corrupted at byte %d\n",
+                CmiMyPe(), hdr->size, hdr->src, i);
+      CmiAbort("pxshm test failed");
+    }
+  }
+  CmiFree(vmsg);
+  if (++CpvAccess(numReceived) == NUM_SIZES * (CmiNumPes() - 1))
+    sendDone();
+}
+
+static void sendAll(void)
+{
+  int s, dest, i;
+  for (s = 0; s < NUM_SIZES; s++) {
+    for (dest = 0; dest < CmiNumPes(); dest++) {
+      int size = msgSizes[s];
+      testMsgHeader *hdr;
+      unsigned char *data;
+      if (dest == CmiMyPe()) continue;
+      hdr = (testMsgHeader *)CmiAlloc(size);
+      data = (unsigned char *)hdr;
+      hdr->src = CmiMyPe();
+      hdr->size = size;
+      for (i = sizeof(testMsgHeader); i < size; i++)
+        data[i] = pattern(hdr->src, size, i);
+      CmiSetHandler(hdr, CpvAccess(dataHandler));
+      CmiSyncSendAndFree(dest, size, hdr);
+    }
+  }
+}
+
+static void testInit(int argc, char **argv)
+{
+  CpvInitialize(int, dataHandler);
+  CpvInitialize(int, doneHandler);
+  CpvInitialize(int, exitHandler);
+  CpvInitialize(int, numReceived);
+  CpvInitialize(int, numDone);
+  CpvAccess(dataHandler) = CmiRegisterHandler(dataHandlerFunc);
+  CpvAccess(doneHandler) = CmiRegisterHandler(doneHandlerFunc);
+  CpvAccess(exitHandler) = CmiRegisterHandler(exitHandlerFunc);
+  CpvAccess(numReceived) = 0;
+  CpvAccess(numDone) = 0;
+
+  if (CmiNumPes() == 1) {
+    CmiPrintf("note: the pxshm test requires at least 2 processors\n");
+    sendDone();
+    return;
+  }
+  sendAll();
+}
+
+int main(int argc, char **argv)
+{
+  ConverseInit(argc, argv, testInit, 0, 0);
+  return 0;
+}